@@ -0,0 +1,107 @@
+// Loads the fastest engine build this browser supports (see Makefile) as the global Module.
+// docs/index.html switches from its plain index.js script tag to this loader once the
+// SIMD and SIMD+threads builds are committed next to the baseline.
+(function () {
+  const VARIANTS = [
+    { name: 'simd-mt', js: 'index.simd-mt.js', wasm: 'index.simd-mt.wasm', simd: true, threads: true },
+    { name: 'simd', js: 'index.simd.js', wasm: 'index.simd.wasm', simd: true, threads: false },
+    { name: 'baseline', js: 'index.js', wasm: 'index.wasm', simd: false, threads: false }
+  ];
+
+  // Engine functions docs/index.html calls; a build without all of them is out of date
+  const REQUIRED_EXPORTS = [
+    'initBoard', 'getBoard', 'makeMove', 'getPendingPromotionSquare', 'promotePawn', 'currentTurn',
+    'getGameState', 'playMove', 'makeAIMove', 'setSkillLevel', 'getSkillLevel', 'searchStart',
+    'searchStep', 'searchResult', 'searchCancel', 'saveHashTable', 'loadHashTable'
+  ];
+
+  // Smallest modules using a v128 instruction and shared memory atomics respectively
+  const SIMD_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+  ]);
+  const THREADS_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 4, 1, 96, 0, 0, 3, 2, 1, 0, 5, 4, 1, 3, 1, 1, 10, 11, 1, 9, 0, 65, 0, 254, 16, 2, 0, 26, 11
+  ]);
+
+  function supportsSimd() {
+    try {
+      return WebAssembly.validate(SIMD_PROBE);
+    } catch (e) {
+      return false;
+    }
+  }
+
+  // Threads need SharedArrayBuffer, which browsers only expose to cross-origin isolated pages
+  function supportsThreads() {
+    if (typeof SharedArrayBuffer === 'undefined' || !self.crossOriginIsolated) return false;
+    try {
+      return WebAssembly.validate(THREADS_PROBE);
+    } catch (e) {
+      return false;
+    }
+  }
+
+  // Compile while the bytes are still downloading; fall back when the server's MIME type prevents it
+  function compileWasm(url) {
+    if (WebAssembly.compileStreaming) {
+      return WebAssembly.compileStreaming(fetch(url)).catch(() => compileBuffered(url));
+    }
+    return compileBuffered(url);
+  }
+
+  function compileBuffered(url) {
+    return fetch(url).then(response => {
+      if (!response.ok) throw new Error(`Failed to fetch ${url}: ${response.status}`);
+      return response.arrayBuffer();
+    }).then(bytes => WebAssembly.compile(bytes));
+  }
+
+  function loadScript(src) {
+    return new Promise((resolve, reject) => {
+      const script = document.createElement('script');
+      script.src = src;
+      script.onload = resolve;
+      script.onerror = () => reject(new Error(`Failed to load ${src}`));
+      document.head.appendChild(script);
+    });
+  }
+
+  function loadVariant(variant) {
+    return compileWasm(variant.wasm).then(wasmModule => new Promise((resolve, reject) => {
+      window.Module = {
+        mainScriptUrlOrBlob: variant.js,
+        // Hand the precompiled module to the Emscripten runtime instead of fetching it again
+        instantiateWasm(imports, receiveInstance) {
+          WebAssembly.instantiate(wasmModule, imports)
+            .then(instance => receiveInstance(instance, wasmModule))
+            .catch(reject);
+          return {};
+        },
+        onRuntimeInitialized() {
+          const missing = REQUIRED_EXPORTS.filter(name => typeof window.Module['_' + name] !== 'function');
+          if (missing.length) reject(new Error(`${variant.js} is missing ${missing.join(', ')}; rebuild with make build`));
+          else resolve(variant);
+        }
+      };
+      loadScript(variant.js).catch(reject);
+    }));
+  }
+
+  // Resolves with the variant that was loaded once Module is ready to use
+  window.loadChessEngine = function () {
+    const simd = supportsSimd();
+    const threads = supportsThreads();
+    const candidates = VARIANTS.filter(v => (!v.simd || simd) && (!v.threads || threads));
+
+    return candidates.reduce(
+      (attempt, variant) => attempt.catch(error => {
+        if (error) console.warn(`Engine variant unavailable, trying ${variant.name}:`, error);
+        return loadVariant(variant);
+      }),
+      Promise.reject(null)
+    ).then(variant => {
+      window.chessEngineVariant = variant;
+      return variant;
+    });
+  };
+})();
@@ -0,0 +1,189 @@
+#include "cluster.h"
+#include "engine.h"
+#include "tt.h"
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+bool clusterSendAll(int fd, const void* data, size_t size) {
+    const char* bytes = (const char*)data;
+    while (size > 0) {
+        ssize_t sent = send(fd, bytes, size, 0);
+        if (sent <= 0) return false;
+        bytes += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+bool clusterRecvAll(int fd, void* data, size_t size) {
+    char* bytes = (char*)data;
+    while (size > 0) {
+        ssize_t received = recv(fd, bytes, size, 0);
+        if (received <= 0) return false;
+        bytes += received;
+        size -= received;
+    }
+    return true;
+}
+
+static bool socketAddress(const char* socketPath, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) return false;
+    strcpy(address.sun_path, socketPath);
+    return true;
+}
+
+int clusterListen(const char* socketPath, int backlog) {
+    sockaddr_un address;
+    if (!socketAddress(socketPath, address)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    unlink(socketPath); // Left over from an earlier coordinator
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, backlog) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int clusterConnect(const char* socketPath) {
+    sockaddr_un address;
+    if (!socketAddress(socketPath, address)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int runClusterWorker(const char* socketPath, const char* sharedTableName) {
+    signal(SIGPIPE, SIG_IGN); // A vanished coordinator shows up as a failed send
+
+    if (!attachSharedHashTable(sharedTableName, 0, false)) {
+        fprintf(stderr, "worker %d: cannot attach shared table %s\n", (int)getpid(), sharedTableName);
+        return 1;
+    }
+    int fd = clusterConnect(socketPath);
+    if (fd < 0) {
+        fprintf(stderr, "worker %d: cannot connect to %s\n", (int)getpid(), socketPath);
+        detachSharedHashTable();
+        return 1;
+    }
+
+    ClusterTask task;
+    while (clusterRecvAll(fd, &task, sizeof(task)) && task.type == CLUSTER_TASK_SEARCH) {
+        loadPosition(&task.position);
+
+        MoveUndo undo;
+        doMove(task.rootMove, &undo);
+        int score = minimax(task.depth, -1000000, 1000000, !task.whiteToMove);
+        undoMove(task.rootMove, &undo);
+
+        ClusterResult result = {task.taskId, task.rootMove, score};
+        if (!clusterSendAll(fd, &result, sizeof(result))) break;
+    }
+
+    close(fd);
+    detachSharedHashTable();
+    return 0;
+}
+
+Move clusterFindBestMove(std::vector<int>& workerFds, bool white, int depth) {
+    Move legalMoves[MAX_LEGAL_MOVES];
+    int moveCount = generateLegalMoves(white, legalMoves);
+    if (moveCount == 0) return MOVE_NONE;
+
+    ClusterTask task = {};
+    task.type = CLUSTER_TASK_SEARCH;
+    savePosition(&task.position);
+    task.whiteToMove = white;
+    task.depth = depth;
+
+    std::vector<int> scores(moveCount);
+    std::deque<int> pending;
+    for (int i = 0; i < moveCount; ++i) pending.push_back(i);
+    std::vector<int> assigned(workerFds.size(), -1); // Root move index per worker, -1 = idle
+    int remaining = moveCount;
+
+    // Drops a worker, putting its root move back in the queue
+    auto dropWorker = [&](size_t w) {
+        if (assigned[w] != -1) pending.push_front(assigned[w]);
+        close(workerFds[w]);
+        workerFds.erase(workerFds.begin() + w);
+        assigned.erase(assigned.begin() + w);
+    };
+
+    while (remaining > 0) {
+        // Hand a root move to every idle worker
+        for (size_t w = 0; w < workerFds.size() && !pending.empty();) {
+            if (assigned[w] != -1) {
+                ++w;
+                continue;
+            }
+            int index = pending.front();
+            pending.pop_front();
+            task.taskId = index;
+            task.rootMove = legalMoves[index];
+            assigned[w] = index;
+            if (!clusterSendAll(workerFds[w], &task, sizeof(task))) {
+                dropWorker(w);
+                continue;
+            }
+            ++w;
+        }
+        if (workerFds.empty()) return MOVE_NONE;
+
+        std::vector<pollfd> polls;
+        for (int fd : workerFds) polls.push_back({fd, POLLIN, 0});
+        if (poll(polls.data(), polls.size(), -1) < 0) continue;
+
+        // Back to front so dropping a worker keeps earlier indices valid
+        for (size_t w = polls.size(); w-- > 0;) {
+            if (polls[w].revents == 0) continue;
+
+            ClusterResult result;
+            bool valid = clusterRecvAll(workerFds[w], &result, sizeof(result)) &&
+                         (int)result.taskId == assigned[w];
+            if (!valid) {
+                dropWorker(w);
+                continue;
+            }
+            scores[result.taskId] = result.score;
+            assigned[w] = -1;
+            remaining--;
+        }
+    }
+
+    // Same choice as findBestMove: first strictly best move, else the first legal one
+    int bestScore = white ? -1000000 : 1000000;
+    Move bestMove = MOVE_NONE;
+    for (int i = 0; i < moveCount; ++i) {
+        if ((white && scores[i] > bestScore) || (!white && scores[i] < bestScore)) {
+            bestScore = scores[i];
+            bestMove = legalMoves[i];
+        }
+    }
+    return bestMove == MOVE_NONE ? legalMoves[0] : bestMove;
+}
+
+void clusterShutdown(std::vector<int>& workerFds) {
+    ClusterTask quit = {};
+    quit.type = CLUSTER_TASK_QUIT;
+    for (int fd : workerFds) {
+        clusterSendAll(fd, &quit, sizeof(quit));
+        close(fd);
+    }
+    workerFds.clear();
+}
@@ -0,0 +1,56 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "main.h"
+#include "move.h"
+
+// Multi-process analysis (native builds only).
+//
+// Worker processes attach to one shared-memory transposition table
+// (attachSharedHashTable) and connect to a coordinator over a Unix socket.
+// The coordinator splits the root the same way the threaded findBestMove
+// does: each ClusterTask is one root move to search. A crashed worker only
+// loses its current task, which is handed to another worker.
+
+const uint32_t CLUSTER_TASK_SEARCH = 1;
+const uint32_t CLUSTER_TASK_QUIT = 2;
+
+// Coordinator -> worker
+struct ClusterTask {
+    uint32_t type;    // CLUSTER_TASK_*
+    uint32_t taskId;
+    PositionSnapshot position;
+    uint8_t whiteToMove;
+    Move rootMove;
+    int32_t depth;    // As findBestMove's depth
+};
+
+// Worker -> coordinator
+struct ClusterResult {
+    uint32_t taskId;
+    Move rootMove;
+    int32_t score;    // White's point of view
+};
+
+// Socket helpers; all return false / -1 on failure
+bool clusterSendAll(int fd, const void* data, size_t size);
+bool clusterRecvAll(int fd, void* data, size_t size);
+int clusterListen(const char* socketPath, int backlog);
+int clusterConnect(const char* socketPath);
+
+// Worker loop: attaches the shared table, connects, searches tasks until told to quit.
+// Returns a process exit code.
+int runClusterWorker(const char* socketPath, const char* sharedTableName);
+
+// Coordinator side of findBestMove for the current position. Workers whose
+// connection fails are closed and removed from 'workerFds'. Returns MOVE_NONE if
+// there are no legal moves or no workers left.
+Move clusterFindBestMove(std::vector<int>& workerFds, bool white, int depth);
+
+// Sends CLUSTER_TASK_QUIT to every worker and closes the connections
+void clusterShutdown(std::vector<int>& workerFds);
+
+#endif // CLUSTER_H
@@ -1,94 +1,21 @@
 #include "engine.h"
 #include "main.h"
+#include "eval_params.h"
+#include "tt.h"
 #include <vector>
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <random>
 
-extern int pendingPromotionSquare; 
-
-// Simple piece values
-const int pieceValues[13] = {
-    0,   // Empty
-    100, // White Pawn
-    100, // Black Pawn
-    320, // White Knight
-    320, // Black Knight
-    330, // White Bishop
-    330, // Black Bishop
-    500, // White Rook
-    500, // Black Rook
-    900, // White Queen
-    900, // Black Queen
-    20000, // White King
-    20000  // Black King
-};
-
-// PST arrays
-
-const int pawnPST[64] = {
-   0,  0,  0,  0,  0,  0,  0,  0,
-  50, 50, 50, 50, 50, 50, 50, 50,
-  10, 10, 20, 30, 30, 20, 10, 10,
-   5,  5, 10, 25, 25, 10,  5,  5,
-   0,  0,  0, 20, 20,  0,  0,  0,
-   5, -5,-10,  0,  0,-10, -5,  5,
-   5, 10, 10,-20,-20, 10, 10,  5,
-   0,  0,  0,  0,  0,  0,  0,  0
-};
-
-const int knightPST[64] = {
- -50,-40,-30,-30,-30,-30,-40,-50,
- -40,-20,  0,  5,  5,  0,-20,-40,
- -30,  5, 10, 15, 15, 10,  5,-30,
- -30,  0, 15, 20, 20, 15,  0,-30,
- -30,  5, 15, 20, 20, 15,  5,-30,
- -30,  0, 10, 15, 15, 10,  0,-30,
- -40,-20,  0,  0,  0,  0,-20,-40,
- -50,-40,-30,-30,-30,-30,-40,-50
-};
-
-const int bishopPST[64] = {
- -20,-10,-10,-10,-10,-10,-10,-20,
- -10,  5,  0,  0,  0,  0,  5,-10,
- -10, 10, 10, 10, 10, 10, 10,-10,
- -10,  0, 10, 10, 10, 10,  0,-10,
- -10,  5,  5, 10, 10,  5,  5,-10,
- -10,  0,  5, 10, 10,  5,  0,-10,
- -10,  0,  0,  0,  0,  0,  0,-10,
- -20,-10,-10,-10,-10,-10,-10,-20
-};
+#ifdef ENGINE_THREADS
+#include <thread>
+#ifndef ENGINE_THREAD_COUNT
+#define ENGINE_THREAD_COUNT 4
+#endif
+#endif
 
-const int rookPST[64] = {
-   0,  0,  0,  0,  0,  0,  0,  0,
-   5, 10, 10, 10, 10, 10, 10,  5,
-  -5,  0,  0,  0,  0,  0,  0, -5,
-  -5,  0,  0,  0,  0,  0,  0, -5,
-  -5,  0,  0,  0,  0,  0,  0, -5,
-  -5,  0,  0,  0,  0,  0,  0, -5,
-  -5,  0,  0,  0,  0,  0,  0, -5,
-   0,  0,  0,  5,  5,  0,  0,  0
-};
-
-const int queenPST[64] = {
- -20,-10,-10, -5, -5,-10,-10,-20,
- -10,  0,  0,  0,  0,  0,  0,-10,
- -10,  0,  5,  5,  5,  5,  0,-10,
-  -5,  0,  5,  5,  5,  5,  0, -5,
-   0,  0,  5,  5,  5,  5,  0, -5,
- -10,  5,  5,  5,  5,  5,  0,-10,
- -10,  0,  5,  0,  0,  0,  0,-10,
- -20,-10,-10, -5, -5,-10,-10,-20
-};
-
-const int kingPST[64] = {
- -30,-40,-40,-50,-50,-40,-40,-30,
- -30,-40,-40,-50,-50,-40,-40,-30,
- -30,-40,-40,-50,-50,-40,-40,-30,
- -30,-40,-40,-50,-50,-40,-40,-30,
- -20,-30,-30,-40,-40,-30,-30,-20,
- -10,-20,-20,-20,-20,-20,-20,-10,
-  20, 20,  0,  0,  0,  0, 20, 20,
-  20, 30, 10,  0,  0, 10, 30, 20
-};
+extern int pendingPromotionSquare; 
 
 // Mirror vertically for black pieces (flip ranks)
 inline int mirrorIndex(int idx) {
@@ -98,24 +25,20 @@ inline int mirrorIndex(int idx) {
     return mirroredRank * 8 + file;
 }
 
+// PST bonus for the piece's own side. Tables are laid out from Black's side
+// of the board (a8 first), so White squares are mirrored.
 int pstScoreForPiece(int piece, int square) {
     if (piece == 0) return 0;
     bool isWhite = (piece % 2 == 1);
     int pstIndex = isWhite ? mirrorIndex(square) : square;
 
     switch (piece) {
-        case 1:  return pawnPST[pstIndex];
-        case 2:  return -pawnPST[mirrorIndex(pstIndex)];
-        case 3:  return knightPST[pstIndex];
-        case 4:  return -knightPST[mirrorIndex(pstIndex)];
-        case 5:  return bishopPST[pstIndex];
-        case 6:  return -bishopPST[mirrorIndex(pstIndex)];
-        case 7:  return rookPST[pstIndex];
-        case 8:  return -rookPST[mirrorIndex(pstIndex)];
-        case 9:  return queenPST[pstIndex];
-        case 10: return -queenPST[mirrorIndex(pstIndex)];
-        case 11: return kingPST[pstIndex];
-        case 12: return -kingPST[mirrorIndex(pstIndex)];
+        case 1:  case 2:  return pawnPST[pstIndex];
+        case 3:  case 4:  return knightPST[pstIndex];
+        case 5:  case 6:  return bishopPST[pstIndex];
+        case 7:  case 8:  return rookPST[pstIndex];
+        case 9:  case 10: return queenPST[pstIndex];
+        case 11: case 12: return kingPST[pstIndex];
         default: return 0;
     }
 }
@@ -139,69 +62,106 @@ int evaluateBoard() {
     return score;
 }
 
+// Ordering score for a move about to be played from the current position (higher first)
+int scoreMove(Move move) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    int piece = board[from];
+    int moveScore = 0;
+
+    if (board[to] != 0) {
+        // Capture: victim value - attacker value (higher better)
+        moveScore = pieceValues[board[to]] - pieceValues[piece];
+    } else if (moveFlags(move) == MOVE_FLAG_EN_PASSANT) {
+        moveScore = 0; // Pawn takes pawn
+    } else {
+        // Non-capture: use PST difference
+        moveScore = pstScoreForPiece(piece, to) - pstScoreForPiece(piece, from);
+    }
+    if (isPromotion(move)) {
+        moveScore += pieceValues[promotionPiece(move, piece % 2 == 1)];
+    }
+    return moveScore;
+}
+
+// Node accounting for budgeted searches (skill levels); a search that runs out is discarded.
+// Each thread counts in threadNodes and adds a batch to the shared total every NODE_BATCH nodes.
+const long NODE_BATCH = 256;
+static std::atomic<long> searchNodes(0);
+static long searchNodeLimit = 0; // 0 = unlimited
+static std::atomic<bool> searchAborted(false);
+static POSITION_LOCAL long threadNodes = 0;
+
 int minimax(int depth, int alpha, int beta, bool maximizingPlayer) {
+    if (searchAborted) return 0;
+    if (searchNodeLimit != 0 && ++threadNodes == NODE_BATCH) {
+        threadNodes = 0;
+        if ((searchNodes += NODE_BATCH) > searchNodeLimit) {
+            searchAborted = true;
+            return 0;
+        }
+    }
+
     if (depth == 0) {
         return evaluateBoard();
     }
+
+    // Transposition table: cut off on a deep enough result, else use its move first
+    uint64_t key = positionKeyFor(maximizingPlayer);
+    Move hashMove = MOVE_NONE;
+    int ttScore, ttDepth, ttBound;
+    if (ttProbe(key, ttScore, hashMove, ttDepth, ttBound) && ttDepth >= depth) {
+        if (ttBound == TT_BOUND_EXACT) return ttScore;
+        if (ttBound == TT_BOUND_LOWER && ttScore >= beta) return ttScore;
+        if (ttBound == TT_BOUND_UPPER && ttScore <= alpha) return ttScore;
+    }
+    int alphaOrig = alpha;
+    int betaOrig = beta;
   
     int bestScore = maximizingPlayer ? -1000000 : 1000000;
-    bool moveFound = false;
+    Move bestMove = MOVE_NONE;
 
-    struct Move {
-        int from;
-        int to;
+    struct ScoredMove {
+        Move move;
         int score;
     };
-    std::vector<Move> moves;
+    Move legalMoves[MAX_LEGAL_MOVES];
+    int moveCount = generateLegalMoves(maximizingPlayer, legalMoves);
 
-    // Generate moves with scores for ordering
-    for (int from = 0; from < 64; ++from) {
-        if (board[from] == 0 || (board[from] % 2 == 1) != maximizingPlayer) continue;
-
-        for (int to = 0; to < 64; ++to) {
-            if (!isValidMove(from, to)) continue;
-            if (wouldKingBeInCheckAfterMove(from, to)) continue;
-
-            int moveScore = 0;
-            if (board[to] != 0) {
-                // Capture: victim value - attacker value (higher better)
-                moveScore = pieceValues[board[to]] - pieceValues[board[from]];
-            } else {
-                // Non-capture: use PST difference
-                int piece = board[from];
-                int pstFrom = pstScoreForPiece(piece, from);
-                int pstTo = pstScoreForPiece(piece, to);
-                moveScore = pstTo - pstFrom;
-            }
-
-            moves.push_back({from, to, moveScore});
+    if (moveCount == 0) {
+        bool inCheck = isInCheck(maximizingPlayer);
+        if (inCheck) {
+            return maximizingPlayer ? -1000000 : 1000000;
+        } else {
+            return 0;
         }
     }
 
+    // Generate moves with scores for ordering
+    ScoredMove moves[MAX_LEGAL_MOVES];
+    for (int i = 0; i < moveCount; ++i) {
+        int moveScore = (legalMoves[i] == hashMove) ? 1000000 : scoreMove(legalMoves[i]);
+        moves[i] = {legalMoves[i], moveScore};
+    }
+
     // Sort moves descending by score for better pruning
-    std::sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+    std::sort(moves, moves + moveCount, [](const ScoredMove& a, const ScoredMove& b) {
         return a.score > b.score;
     });
 
     // Search moves in order
-    for (const Move& move : moves) {
-        moveFound = true;
-
-        // Save board state
-        uint8_t backupTo = board[move.to];
-        board[move.to] = board[move.from];
-        board[move.from] = 0;
-
+    for (int i = 0; i < moveCount; ++i) {
+        MoveUndo undo;
+        doMove(moves[i].move, &undo);
         int score = minimax(depth - 1, alpha, beta, !maximizingPlayer);
-
-        // Undo move
-        board[move.from] = board[move.to];
-        board[move.to] = backupTo;
+        undoMove(moves[i].move, &undo);
 
         if (maximizingPlayer) {
+            if (score > bestScore || bestMove == MOVE_NONE) bestMove = moves[i].move;
             bestScore = std::max(bestScore, score);
             alpha = std::max(alpha, score);
         } else {
+            if (score < bestScore || bestMove == MOVE_NONE) bestMove = moves[i].move;
             bestScore = std::min(bestScore, score);
             beta = std::min(beta, score);
         }
@@ -209,71 +169,196 @@ int minimax(int depth, int alpha, int beta, bool maximizingPlayer) {
         if (beta <= alpha) break;
     }
 
-    if (!moveFound) {
-        bool inCheck = isInCheck(maximizingPlayer);
-        if (inCheck) {
-            return maximizingPlayer ? -1000000 : 1000000;
-        } else {
-            return 0;
-        }
-    }
+    // Scores from a search that ran out of nodes are meaningless
+    if (searchAborted) return bestScore;
+
+    int bound = (bestScore <= alphaOrig) ? TT_BOUND_UPPER
+              : (bestScore >= betaOrig) ? TT_BOUND_LOWER
+              : TT_BOUND_EXACT;
+    ttStore(key, bestScore, bestMove, depth, bound);
 
     return bestScore;
 }
 
-int findBestMove(bool white, int depth) {
-    int bestScore = white ? -1000000 : 1000000;
-    int bestMove = -1;
+struct RootMove {
+    Move move;
+    int score; // White's point of view, like evaluateBoard()
+};
+
+// Search root moves handed out through 'next' until none are left
+static void searchRootMoves(std::vector<RootMove>& rootMoves, std::atomic<int>& next, bool white, int depth) {
+    threadNodes = 0;
+    for (int i = next++; i < (int)rootMoves.size(); i = next++) {
+        MoveUndo undo;
+        doMove(rootMoves[i].move, &undo);
+        rootMoves[i].score = minimax(depth, -1000000, 1000000, !white);
+        undoMove(rootMoves[i].move, &undo);
+    }
+}
+
+// Scores every root move at 'depth'. Each gets a full window, so all scores are exact.
+static void scoreRootMoves(std::vector<RootMove>& rootMoves, bool white, int depth) {
+    std::atomic<int> next(0);
+
+#ifdef ENGINE_THREADS
+    // Root split: helper threads pull root moves from the same counter,
+    // each searching its own copy of the position
+    PositionSnapshot root;
+    savePosition(&root);
+
+    int helperCount = std::min<int>(ENGINE_THREAD_COUNT, (int)rootMoves.size()) - 1;
+    std::vector<std::thread> helpers;
+    for (int t = 0; t < helperCount; ++t) {
+        helpers.emplace_back([&]() {
+            loadPosition(&root);
+            searchRootMoves(rootMoves, next, white, depth);
+        });
+    }
+    searchRootMoves(rootMoves, next, white, depth);
+    for (std::thread& helper : helpers) helper.join();
+#else
+    searchRootMoves(rootMoves, next, white, depth);
+#endif
+}
+
+// All legal root moves, best first for 'white'. With a node limit the search deepens
+// one ply at a time and keeps the last depth that finished inside the budget.
+static std::vector<RootMove> rankRootMoves(bool white, int depth, long nodeLimit) {
+    Move legalMoves[MAX_LEGAL_MOVES];
+    int moveCount = generateLegalMoves(white, legalMoves);
+
+    std::vector<RootMove> ranked(moveCount);
+    for (int i = 0; i < moveCount; ++i) ranked[i] = {legalMoves[i], 0};
+    if (moveCount == 0) return ranked;
+
+    searchNodes = 0;
+    searchAborted = false;
+    searchNodeLimit = nodeLimit;
+
+    for (int d = (nodeLimit != 0) ? 0 : depth; d <= depth; ++d) {
+        std::vector<RootMove> iteration = ranked;
+        scoreRootMoves(iteration, white, d);
+        if (searchAborted) break;
+        ranked = iteration;
+    }
+    searchNodeLimit = 0;
+    searchAborted = false;
 
-    // Store the first legal move as fallback
-    int fallbackMove = -1;
+    // Stable, so equal scores keep generation order
+    std::stable_sort(ranked.begin(), ranked.end(), [white](const RootMove& a, const RootMove& b) {
+        return white ? a.score > b.score : a.score < b.score;
+    });
+    return ranked;
+}
 
-    for (int from = 0; from < 64; ++from) {
-        if (board[from] == 0 || (board[from] % 2 == 1) != white) continue;
+Move findBestMove(bool white, int depth) {
+    // Positions already searched at least this deep (possibly in an earlier session)
+    uint64_t key = positionKeyFor(white);
+    Move storedMove;
+    int storedDepth;
+    if (bestMoveLookup(key, storedMove, storedDepth) && storedDepth >= depth) {
+        Move legalMoves[MAX_LEGAL_MOVES];
+        int moveCount = generateLegalMoves(white, legalMoves);
+        for (int i = 0; i < moveCount; ++i) {
+            if (legalMoves[i] == storedMove) return storedMove;
+        }
+    }
 
-        for (int to = 0; to < 64; ++to) {
-            if (!isValidMove(from, to)) continue;
-            if (wouldKingBeInCheckAfterMove(from, to)) continue;
+    std::vector<RootMove> ranked = rankRootMoves(white, depth, 0);
+    if (ranked.empty()) return MOVE_NONE;
 
-            // Save first legal move in case all scores are bad
-            if (fallbackMove == -1) fallbackMove = from * 64 + to;
+    bestMoveRecord(key, ranked[0].move, depth);
+    return ranked[0].move;
+}
+
+// ----- Skill levels -----
+// Below MAX_SKILL_LEVEL the AI gets a node budget and picks among its top
+// SKILL_CANDIDATES moves, favouring weaker ones more as the level drops. Its
+// deepening stops a ply short of full strength, so a budget that outlasts the
+// position never costs more than the full-strength search.
 
-            // Save board state
-            uint8_t backupTo = board[to];
-            board[to] = board[from];
-            board[from] = 0;
+const int MAX_SKILL_LEVEL = 20;
+const int SKILL_SEARCH_DEPTH = 4;
+const int SKILL_CANDIDATES = 4;
 
-            int score = minimax(depth, -1000000, 1000000, !white);
+static int skillLevel = MAX_SKILL_LEVEL;
 
-            // Undo move
-            board[from] = board[to];
-            board[to] = backupTo;
+static long skillNodeLimit(int level) {
+    return 1000L << (level / 2); // 1k nodes at level 0, 512k at level 19
+}
 
-            if ((white && score > bestScore) || (!white && score < bestScore)) {
-                bestScore = score;
-                bestMove = from * 64 + to;
-            }
+static Move pickSkillMove(const std::vector<RootMove>& ranked, bool white, int level) {
+    static std::mt19937 rng(std::random_device{}());
+
+    int candidates = std::min<int>(SKILL_CANDIDATES, (int)ranked.size());
+    auto sideScore = [white](const RootMove& m) { return white ? m.score : -m.score; };
+
+    int topScore = sideScore(ranked[0]);
+    int delta = std::min(topScore - sideScore(ranked[candidates - 1]), pieceValues[1]);
+    int weakness = 120 - 2 * level;
+
+    // Random push grows with weakness and with how far a move trails the best one
+    Move chosen = ranked[0].move;
+    int chosenValue = INT32_MIN;
+    for (int i = 0; i < candidates; ++i) {
+        int score = sideScore(ranked[i]);
+        int push = (weakness * (topScore - score) + delta * (int)(rng() % weakness)) / 128;
+        if (score + push > chosenValue) {
+            chosenValue = score + push;
+            chosen = ranked[i].move;
         }
     }
+    return chosen;
+}
 
-    // If no good move was found, fall back to a legal one
-    if (bestMove == -1) bestMove = fallbackMove;
+// ----- Analysis -----
+// Deepest analyzePosition() search; minimax only stops at depth 0, so negative depths are raised to it
+const int MAX_ANALYSIS_DEPTH = 16;
 
-    return bestMove;
-}
+// MultiPV results for analyzePosition(): [count, move0, score0, move1, score1, ...]
+static int32_t multiPV[1 + MAX_LEGAL_MOVES * 2];
 
 extern "C" {
 
     bool makeAIMove() {
         pendingPromotionSquare = -1;  // Clear any leftover promotion state
 
-        int move = findBestMove(false, 4); // false = black
-        if (move == -1) return false;
+        Move move;
+        if (skillLevel >= MAX_SKILL_LEVEL) {
+            move = findBestMove(false, SKILL_SEARCH_DEPTH); // false = black
+        } else {
+            std::vector<RootMove> ranked = rankRootMoves(false, SKILL_SEARCH_DEPTH - 1, skillNodeLimit(skillLevel));
+            move = ranked.empty() ? MOVE_NONE : pickSkillMove(ranked, false, skillLevel);
+        }
+        if (move == MOVE_NONE) return false;
 
-        int from = move / 64;
-        int to = move % 64;
+        return playMove(move);  // Plays the move, promotion piece included
+    }
 
-        return makeMove(from, to);  // Calls the real makeMove from main.cpp
+    // 0 (weakest) to MAX_SKILL_LEVEL (full strength, the default)
+    void setSkillLevel(int level) {
+        skillLevel = std::max(0, std::min(level, MAX_SKILL_LEVEL));
+    }
+
+    int getSkillLevel() {
+        return skillLevel;
+    }
+
+    // Best 'count' root moves for the side to move from one search, with scores from
+    // White's point of view. Returns a pointer to multiPV (layout above) for HEAP32.
+    int32_t* analyzePosition(int depth, int count) {
+        depth = std::max(0, std::min(depth, MAX_ANALYSIS_DEPTH));
+        count = std::max(0, std::min(count, MAX_LEGAL_MOVES));
+        bool white = currentTurn() == 1;
+        std::vector<RootMove> ranked = rankRootMoves(white, depth, 0);
+
+        int lines = std::min(count, (int)ranked.size());
+        multiPV[0] = lines;
+        for (int i = 0; i < lines; ++i) {
+            multiPV[1 + i * 2] = ranked[i].move;
+            multiPV[2 + i * 2] = ranked[i].score;
+        }
+        return multiPV;
     }
 
 }
@@ -1,6 +1,36 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 
-int findBestMove(bool white, int depth = 2);  // Returns best move as encoded (from * 64 + to)
+#include "move.h"
+
+#include <stdint.h>
+#include <vector>
+
+Move findBestMove(bool white, int depth = 2);  // Returns best move as a packed Move, MOVE_NONE if none
+int scoreMove(Move move);  // Move ordering score in the current position, higher first
+int minimax(int depth, int alpha, int beta, bool maximizingPlayer);  // Score from White's point of view
+
+// Proof-number mate search (matesolver.cpp) for 'white' as the attacker; fills 'line' with
+// the shortest forced mate within maxPlies, false if none was found within nodeLimit nodes
+bool solveMate(bool white, int maxPlies, long nodeLimit, std::vector<Move>& line);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    bool makeAIMove();
+    void setSkillLevel(int level);  // 0 (weakest) to 20 (full strength)
+    int getSkillLevel();
+    int32_t* analyzePosition(int depth, int count);  // MultiPV: [count, move, score, ...]
+
+    // Resumable search (stepsearch.cpp) for builds without threads
+    void searchStart(int depth);
+    int searchStep(int nodeBudget);  // 1 once the search has finished
+    int searchResult();              // Best Move once finished, MOVE_NONE otherwise
+    void searchCancel();
+
+    int32_t* findMate(int maxPlies, int nodeLimit);  // Mating line: [count, move0, move1, ...]
+#ifdef __cplusplus
+}
+#endif
 
 #endif
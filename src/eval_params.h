@@ -0,0 +1,92 @@
+// Evaluation parameters included by engine.cpp.
+// Generated by tools/texel_tuner.cpp (make tune).
+
+#ifndef EVAL_PARAMS_H
+#define EVAL_PARAMS_H
+
+// Simple piece values
+const int pieceValues[13] = {
+    0, // Empty
+    100, // White Pawn
+    100, // Black Pawn
+    320, // White Knight
+    320, // Black Knight
+    330, // White Bishop
+    330, // Black Bishop
+    500, // White Rook
+    500, // Black Rook
+    900, // White Queen
+    900, // Black Queen
+    20000, // White King
+    20000  // Black King
+};
+
+// PST arrays
+
+const int pawnPST[64] = {
+    0,   0,   0,   0,   0,   0,   0,   0,
+   50,  50,  50,  50,  50,  50,  50,  50,
+   10,  10,  20,  30,  30,  20,  10,  10,
+    5,   5,  10,  25,  25,  10,   5,   5,
+    0,   0,   0,  20,  20,   0,   0,   0,
+    5,  -5, -10,   0,   0, -10,  -5,   5,
+    5,  10,  10, -20, -20,  10,  10,   5,
+    0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int knightPST[64] = {
+  -50, -40, -30, -30, -30, -30, -40, -50,
+  -40, -20,   0,   5,   5,   0, -20, -40,
+  -30,   5,  10,  15,  15,  10,   5, -30,
+  -30,   0,  15,  20,  20,  15,   0, -30,
+  -30,   5,  15,  20,  20,  15,   5, -30,
+  -30,   0,  10,  15,  15,  10,   0, -30,
+  -40, -20,   0,   0,   0,   0, -20, -40,
+  -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+const int bishopPST[64] = {
+  -20, -10, -10, -10, -10, -10, -10, -20,
+  -10,   5,   0,   0,   0,   0,   5, -10,
+  -10,  10,  10,  10,  10,  10,  10, -10,
+  -10,   0,  10,  10,  10,  10,   0, -10,
+  -10,   5,   5,  10,  10,   5,   5, -10,
+  -10,   0,   5,  10,  10,   5,   0, -10,
+  -10,   0,   0,   0,   0,   0,   0, -10,
+  -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+const int rookPST[64] = {
+    0,   0,   0,   0,   0,   0,   0,   0,
+    5,  10,  10,  10,  10,  10,  10,   5,
+   -5,   0,   0,   0,   0,   0,   0,  -5,
+   -5,   0,   0,   0,   0,   0,   0,  -5,
+   -5,   0,   0,   0,   0,   0,   0,  -5,
+   -5,   0,   0,   0,   0,   0,   0,  -5,
+   -5,   0,   0,   0,   0,   0,   0,  -5,
+    0,   0,   0,   5,   5,   0,   0,   0
+};
+
+const int queenPST[64] = {
+  -20, -10, -10,  -5,  -5, -10, -10, -20,
+  -10,   0,   0,   0,   0,   0,   0, -10,
+  -10,   0,   5,   5,   5,   5,   0, -10,
+   -5,   0,   5,   5,   5,   5,   0,  -5,
+    0,   0,   5,   5,   5,   5,   0,  -5,
+  -10,   5,   5,   5,   5,   5,   0, -10,
+  -10,   0,   5,   0,   0,   0,   0, -10,
+  -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+const int kingPST[64] = {
+  -30, -40, -40, -50, -50, -40, -40, -30,
+  -30, -40, -40, -50, -50, -40, -40, -30,
+  -30, -40, -40, -50, -50, -40, -40, -30,
+  -30, -40, -40, -50, -50, -40, -40, -30,
+  -20, -30, -30, -40, -40, -30, -30, -20,
+  -10, -20, -20, -20, -20, -20, -20, -10,
+   20,  20,   0,   0,   0,   0,  20,  20,
+   20,  30,  10,   0,   0,  10,  30,  20
+};
+
+#endif // EVAL_PARAMS_H
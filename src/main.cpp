@@ -1,10 +1,18 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+// Native builds (tools/) share this file; exports and JS logging become no-ops
+#define EMSCRIPTEN_KEEPALIVE
+#define EM_ASM(...) ((void)0)
+#endif
 #include <cstdint>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
 #include <algorithm>
 #include <set>
+#include <vector>
+#include <cstring>
 #include "engine.h"
 #include "main.h"
 #include <iostream>
@@ -20,24 +28,40 @@ extern "C" {
     EMSCRIPTEN_KEEPALIVE bool isCheckmate(bool white);
     EMSCRIPTEN_KEEPALIVE bool isStalemate();
     EMSCRIPTEN_KEEPALIVE bool isInsufficientMaterial();
+    EMSCRIPTEN_KEEPALIVE uint8_t* getGameState();
+    EMSCRIPTEN_KEEPALIVE bool playMove(int move);
 }
 
 
 // ------------Internal helper functions/vars-----------------//
 //------------------------------------------------------------//
 
-uint8_t board[64];
+POSITION_LOCAL uint8_t board[64];
             
 static bool whiteToMove = true;
-static int enPassantTarget = -1; // -1 = no en passant possible
-bool hasWhiteKingMoved = false;
-bool hasBlackKingMoved = false;
-bool hasWhiteKingsideRookMoved = false;
-bool hasWhiteQueensideRookMoved = false;
-bool hasBlackKingsideRookMoved = false;
-bool hasBlackQueensideRookMoved = false;
+static POSITION_LOCAL int enPassantTarget = -1; // -1 = no en passant possible
+POSITION_LOCAL bool hasWhiteKingMoved = false;
+POSITION_LOCAL bool hasBlackKingMoved = false;
+POSITION_LOCAL bool hasWhiteKingsideRookMoved = false;
+POSITION_LOCAL bool hasWhiteQueensideRookMoved = false;
+POSITION_LOCAL bool hasBlackKingsideRookMoved = false;
+POSITION_LOCAL bool hasBlackQueensideRookMoved = false;
 int pendingPromotionSquare = -1; // -1 if no promotion is pending
 
+// Keys of every position reached this game (for repetition detection)
+static std::vector<uint64_t> positionHistory;
+
+// Moves played this game from gameStart (for PGN export)
+static std::vector<Move> gameMoves;
+static PositionSnapshot gameStart;
+static bool gameStartWhiteToMove = true;
+static uint32_t gameCounter = 0; // Bumped by every setGamePosition()
+static Move pendingPromotionMove = MOVE_NONE; // makeMove() half of a promotion awaiting promotePawn()
+
+// Packed game state handed to JS through getGameState() (layout in main.h)
+static uint8_t gameState[GAME_STATE_HEADER_SIZE + MAX_LEGAL_MOVES * 2];
+static bool gameStateValid = false; // Cleared whenever the position changes
+
 // Utility to get rank (0-7) and file (0-7) from square index (0-63)
 inline int getRank(int square) { return square / 8; }
 inline int getFile(int square) { return square % 8; }
@@ -53,6 +77,7 @@ bool canAttack(int from, int to, const uint8_t b[64]);
 bool isValidMove(int from, int to);
 bool wouldKingBeInCheckAfterMove(int from, int to);
 bool hasLegalMoves(bool white);
+extern "C" bool isInsufficientMaterial();
         
      
 // Helper: find king position for color on board
@@ -81,6 +106,92 @@ bool isSquareAttacked(int sq, bool byWhite) {
     return isSquareAttackedOnBoard(sq, byWhite, board);
 }
 
+// Zobrist keys, filled once from a fixed seed so keys are stable across runs
+static uint64_t zobristPieces[13][64];
+static uint64_t zobristSideToMove;
+static uint64_t zobristCastling[4];
+static uint64_t zobristEnPassant[64];
+
+static bool initZobrist() {
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    auto next = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    };
+    for (int p = 0; p < 13; ++p)
+        for (int sq = 0; sq < 64; ++sq)
+            zobristPieces[p][sq] = (p == 0) ? 0 : next();
+    zobristSideToMove = next();
+    for (int i = 0; i < 4; ++i) zobristCastling[i] = next();
+    for (int sq = 0; sq < 64; ++sq) zobristEnPassant[sq] = next();
+    return true;
+}
+static bool zobristReady = initZobrist();
+
+// The en passant square if a pawn of 'white' can legally capture there, else -1. Only
+// then does it count for the key: positions differing by an unusable double push repeat.
+static int capturableEnPassantSquare(bool white) {
+    if (enPassantTarget == -1 || getRank(enPassantTarget) != (white ? 5 : 2)) return -1;
+    uint8_t pawn = white ? 1 : 2;
+    int behind = white ? enPassantTarget - 8 : enPassantTarget + 8; // The pushed pawn
+    for (int side = -1; side <= 1; side += 2) {
+        int file = getFile(enPassantTarget) + side;
+        if (file < 0 || file > 7) continue;
+        int from = behind + side;
+        if (board[from] == pawn && !wouldKingBeInCheckAfterMove(from, enPassantTarget)) return enPassantTarget;
+    }
+    return -1;
+}
+
+// Hash of the full position with 'white' to move: board, side, castling rights, en passant
+uint64_t positionKeyFor(bool white) {
+    uint64_t key = 0;
+    for (int sq = 0; sq < 64; ++sq) key ^= zobristPieces[board[sq]][sq];
+    if (!white) key ^= zobristSideToMove;
+    if (!hasWhiteKingMoved && !hasWhiteKingsideRookMoved) key ^= zobristCastling[0];
+    if (!hasWhiteKingMoved && !hasWhiteQueensideRookMoved) key ^= zobristCastling[1];
+    if (!hasBlackKingMoved && !hasBlackKingsideRookMoved) key ^= zobristCastling[2];
+    if (!hasBlackKingMoved && !hasBlackQueensideRookMoved) key ^= zobristCastling[3];
+    int enPassantSquare = capturableEnPassantSquare(white);
+    if (enPassantSquare != -1) key ^= zobristEnPassant[enPassantSquare];
+    return key;
+}
+
+// Key of the game position (the side actually to move)
+uint64_t positionKey() {
+    return positionKeyFor(whiteToMove);
+}
+
+void savePosition(PositionSnapshot* snapshot) {
+    memcpy(snapshot->board, board, 64);
+    snapshot->enPassantTarget = enPassantTarget;
+    snapshot->hasWhiteKingMoved = hasWhiteKingMoved;
+    snapshot->hasBlackKingMoved = hasBlackKingMoved;
+    snapshot->hasWhiteKingsideRookMoved = hasWhiteKingsideRookMoved;
+    snapshot->hasWhiteQueensideRookMoved = hasWhiteQueensideRookMoved;
+    snapshot->hasBlackKingsideRookMoved = hasBlackKingsideRookMoved;
+    snapshot->hasBlackQueensideRookMoved = hasBlackQueensideRookMoved;
+}
+
+void loadPosition(const PositionSnapshot* snapshot) {
+    memcpy(board, snapshot->board, 64);
+    enPassantTarget = snapshot->enPassantTarget;
+    hasWhiteKingMoved = snapshot->hasWhiteKingMoved;
+    hasBlackKingMoved = snapshot->hasBlackKingMoved;
+    hasWhiteKingsideRookMoved = snapshot->hasWhiteKingsideRookMoved;
+    hasWhiteQueensideRookMoved = snapshot->hasWhiteQueensideRookMoved;
+    hasBlackKingsideRookMoved = snapshot->hasBlackKingsideRookMoved;
+    hasBlackQueensideRookMoved = snapshot->hasBlackQueensideRookMoved;
+}
+
+// Called after every change to the game position
+static void positionChanged() {
+    gameStateValid = false;
+    positionHistory.push_back(positionKey());
+}
+
 // Helper to check if any legal moves exist for the side to move
 bool hasLegalMoves(bool white) {
     for (int from = 0; from < 64; ++from) {
@@ -367,6 +478,171 @@ bool wouldKingBeInCheckAfterMove(int from, int to) {
     return isSquareAttackedOnBoard(kingPos, !white, tempBoard);
 }
 
+// Flags for a move already known to be valid; promotions come back as queen promotions
+static int classifyMove(int from, int to) {
+    uint8_t piece = board[from];
+    bool capture = board[to] != 0;
+
+    if (piece == 1 || piece == 2) {
+        if (std::abs(to - from) == 16) return MOVE_FLAG_DOUBLE_PAWN_PUSH;
+        if (to == enPassantTarget && !capture && getFile(to) != getFile(from)) return MOVE_FLAG_EN_PASSANT;
+        if (getRank(to) == 7 || getRank(to) == 0) {
+            return MOVE_FLAG_PROMOTION + 3 + (capture ? MOVE_FLAG_CAPTURE : 0);
+        }
+    }
+    if ((piece == 11 || piece == 12) && std::abs(to - from) == 2) {
+        return to > from ? MOVE_FLAG_KING_CASTLE : MOVE_FLAG_QUEEN_CASTLE;
+    }
+    return capture ? MOVE_FLAG_CAPTURE : MOVE_FLAG_QUIET;
+}
+
+// The legal move from 'from' to 'to' for the piece on 'from', or MOVE_NONE
+Move legalMoveFor(int from, int to) {
+    if (!isValidMove(from, to)) return MOVE_NONE;
+    if (wouldKingBeInCheckAfterMove(from, to)) return MOVE_NONE;
+    return encodeMove(from, to, classifyMove(from, to));
+}
+
+int generateLegalMoves(bool white, Move* moves) {
+    int count = 0;
+    for (int from = 0; from < 64; ++from) {
+        if (board[from] == 0 || (board[from] % 2 == 1) != white) continue;
+
+        for (int to = 0; to < 64; ++to) {
+            Move move = legalMoveFor(from, to);
+            if (move == MOVE_NONE) continue;
+
+            if (isPromotion(move)) {
+                // Queen first, then the underpromotions
+                int captureFlag = moveFlags(move) & MOVE_FLAG_CAPTURE;
+                for (int promo = 3; promo >= 0 && count < MAX_LEGAL_MOVES; --promo) {
+                    moves[count++] = encodeMove(from, to, MOVE_FLAG_PROMOTION + promo + captureFlag);
+                }
+            } else if (count < MAX_LEGAL_MOVES) {
+                moves[count++] = move;
+            }
+        }
+    }
+    return count;
+}
+
+void doMove(Move move, MoveUndo* undo) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    int flags = moveFlags(move);
+    uint8_t piece = board[from];
+    bool white = (piece % 2) == 1;
+
+    undo->captured = board[to];
+    undo->enPassantTarget = enPassantTarget;
+    undo->hasWhiteKingMoved = hasWhiteKingMoved;
+    undo->hasBlackKingMoved = hasBlackKingMoved;
+    undo->hasWhiteKingsideRookMoved = hasWhiteKingsideRookMoved;
+    undo->hasWhiteQueensideRookMoved = hasWhiteQueensideRookMoved;
+    undo->hasBlackKingsideRookMoved = hasBlackKingsideRookMoved;
+    undo->hasBlackQueensideRookMoved = hasBlackQueensideRookMoved;
+
+    // ----- Handle en passant capture -----
+    if (flags == MOVE_FLAG_EN_PASSANT) {
+        int capturedPawnSq = white ? to - 8 : to + 8;
+        undo->captured = board[capturedPawnSq];
+        board[capturedPawnSq] = 0;
+    }
+
+    // ----- Handle castling rook movement -----
+    if (flags == MOVE_FLAG_KING_CASTLE) {
+        board[from + 1] = board[from + 3];
+        board[from + 3] = 0;
+    } else if (flags == MOVE_FLAG_QUEEN_CASTLE) {
+        board[from - 1] = board[from - 4];
+        board[from - 4] = 0;
+    }
+
+    // ----- Move the piece -----
+    board[to] = isPromotion(move) ? promotionPiece(move, white) : piece;
+    board[from] = 0;
+
+    // ----- Set en passant target for pawn double moves -----
+    enPassantTarget = (flags == MOVE_FLAG_DOUBLE_PAWN_PUSH) ? (from + to) / 2 : -1;
+
+    // ----- Track if kings or rooks move (or rooks get captured) -----
+    if (piece == 11) hasWhiteKingMoved = true;
+    if (piece == 12) hasBlackKingMoved = true;
+    if (from == 0 || to == 0) hasWhiteQueensideRookMoved = true;
+    if (from == 7 || to == 7) hasWhiteKingsideRookMoved = true;
+    if (from == 56 || to == 56) hasBlackQueensideRookMoved = true;
+    if (from == 63 || to == 63) hasBlackKingsideRookMoved = true;
+}
+
+void undoMove(Move move, const MoveUndo* undo) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    int flags = moveFlags(move);
+    bool white = (board[to] % 2) == 1;
+
+    board[from] = isPromotion(move) ? (white ? 1 : 2) : board[to];
+
+    if (flags == MOVE_FLAG_EN_PASSANT) {
+        board[to] = 0;
+        board[white ? to - 8 : to + 8] = undo->captured;
+    } else {
+        board[to] = undo->captured;
+    }
+
+    if (flags == MOVE_FLAG_KING_CASTLE) {
+        board[from + 3] = board[from + 1];
+        board[from + 1] = 0;
+    } else if (flags == MOVE_FLAG_QUEEN_CASTLE) {
+        board[from - 4] = board[from - 1];
+        board[from - 1] = 0;
+    }
+
+    enPassantTarget = undo->enPassantTarget;
+    hasWhiteKingMoved = undo->hasWhiteKingMoved;
+    hasBlackKingMoved = undo->hasBlackKingMoved;
+    hasWhiteKingsideRookMoved = undo->hasWhiteKingsideRookMoved;
+    hasWhiteQueensideRookMoved = undo->hasWhiteQueensideRookMoved;
+    hasBlackKingsideRookMoved = undo->hasBlackKingsideRookMoved;
+    hasBlackQueensideRookMoved = undo->hasBlackQueensideRookMoved;
+}
+
+// Fill gameState for the current position: one legal-move scan plus status flags
+static void computeGameState() {
+    bool white = whiteToMove;
+    Move legalMoves[MAX_LEGAL_MOVES];
+    int moveCount = generateLegalMoves(white, legalMoves);
+
+    uint8_t* moves = gameState + GAME_STATE_HEADER_SIZE;
+    for (int i = 0; i < moveCount; ++i) {
+        moves[i * 2] = legalMoves[i] & 0xFF;
+        moves[i * 2 + 1] = legalMoves[i] >> 8;
+    }
+
+    int kingSquare = findKing(white, board);
+    bool inCheck = isSquareAttacked(kingSquare, !white);
+
+    uint8_t flags = 0;
+    if (inCheck) flags |= GAME_STATUS_CHECK;
+    if (moveCount == 0) flags |= inCheck ? GAME_STATUS_CHECKMATE : GAME_STATUS_STALEMATE;
+    if (isInsufficientMaterial()) flags |= GAME_STATUS_INSUFFICIENT_MATERIAL;
+
+    // Threefold repetition of the current position
+    if (!positionHistory.empty()) {
+        uint64_t key = positionHistory.back();
+        int seen = 0;
+        for (uint64_t k : positionHistory) {
+            if (k == key) seen++;
+        }
+        if (seen >= 3) flags |= GAME_STATUS_REPETITION;
+    }
+
+    gameState[0] = flags;
+    gameState[1] = white ? 1 : 2;
+    gameState[2] = kingSquare;
+    gameState[3] = moveCount;
+    gameStateValid = true;
+}
+
 //--------------------Global functions/vars--------------------//
 //-------------------------------------------------------------//
     
@@ -376,6 +652,7 @@ extern "C" EMSCRIPTEN_KEEPALIVE bool isInCheck(bool white) {
 }
 
 extern "C" EMSCRIPTEN_KEEPALIVE bool isCheckmate(bool white) {
+    if (white == whiteToMove) return getGameState()[0] & GAME_STATUS_CHECKMATE;
     return isInCheck(white) && !hasLegalMoves(white);
 }
 
@@ -384,12 +661,18 @@ extern "C" EMSCRIPTEN_KEEPALIVE int getKingSquare(bool white) {
 }
 
 extern "C" EMSCRIPTEN_KEEPALIVE int getBestAIMove(bool white) {
-    return findBestMove(white);  // Returns from * 64 + to
+    return findBestMove(white);  // Returns a packed Move (see move.h), 0 if none
 }
 
 extern "C" EMSCRIPTEN_KEEPALIVE bool isStalemate() {
-    bool white = whiteToMove;
-    return !isInCheck(white) && !hasLegalMoves(white);
+    return getGameState()[0] & GAME_STATUS_STALEMATE;
+}
+
+// Legal moves and game status for the side to move, computed once per position.
+// Returns a pointer into the WASM heap; JS reads it through HEAPU8 (layout above).
+extern "C" EMSCRIPTEN_KEEPALIVE uint8_t* getGameState() {
+    if (!gameStateValid) computeGameState();
+    return gameState;
 }
 
 extern "C" EMSCRIPTEN_KEEPALIVE bool isInsufficientMaterial() {
@@ -446,89 +729,56 @@ extern "C" EMSCRIPTEN_KEEPALIVE bool isInsufficientMaterial() {
 }
 
 extern "C" EMSCRIPTEN_KEEPALIVE bool makeMove(int from, int to) {
+    if (from < 0 || from >= 64 || to < 0 || to >= 64) return false;
     uint8_t piece = board[from];   
     if (piece == 0) return false;
 
     bool isWhitePiece = (piece % 2) == 1;
     if (whiteToMove != isWhitePiece) return false;  
 
-    if (!isValidMove(from, to)) return false;
-
-    // Check if move leaves king in check
-    if (wouldKingBeInCheckAfterMove(from, to)) return false;
-
-    // ----- Handle en passant capture -----
-    if ((piece == 1 || piece == 2) && to == enPassantTarget) {
-        int capturedPawnSq = isWhitePiece ? to - 8 : to + 8;
-        board[capturedPawnSq] = 0;
-    }
-
-    // ----- Handle castling rook movement -----
-    if (piece == 11) { // White king
-        if (from == 4 && to == 6) { // Kingside castling
-            board[5] = board[7];
-            board[7] = 0;
-        } else if (from == 4 && to == 2) { // Queenside castling
-            board[3] = board[0];
-            board[0] = 0;
-        }
-    } else if (piece == 12) { // Black king
-        if (from == 60 && to == 62) { // Kingside castling
-            board[61] = board[63];
-            board[63] = 0;
-        } else if (from == 60 && to == 58) { // Queenside castling
-            board[59] = board[56];
-            board[56] = 0;
-        }
-    }
-
-    // ----- Move the piece -----
-    board[to] = board[from];
-    board[from] = 0;
-
-    // ----- Reset en passant target -----
-    enPassantTarget = -1;
-
-    // ----- Set en passant target for pawn double moves -----
-    int fromRank = getRank(from);
-    int toRank = getRank(to);
-    if (piece == 1 && fromRank == 1 && toRank == 3) {
-        enPassantTarget = from + 8;
-    } else if (piece == 2 && fromRank == 6 && toRank == 4) {
-        enPassantTarget = from - 8;
-    }
-
-    // ----- Track if kings or rooks move -----
-    if (piece == 11) hasWhiteKingMoved = true;
-    if (piece == 12) hasBlackKingMoved = true;
-    if (from == 0) hasWhiteQueensideRookMoved = true;
-    if (from == 7) hasWhiteKingsideRookMoved = true;
-    if (from == 56) hasBlackQueensideRookMoved = true;
-    if (from == 63) hasBlackKingsideRookMoved = true;
-
-    // Check for promotion
-    if ((piece == 1 && to / 8 == 7) || (piece == 2 && to / 8 == 0)) {
-        if ((piece % 2 == 0)) {
-            // Black pawn (AI) promotes automatically
-            EM_ASM({
-                console.log("AI reached promotion rank at " + $0);
-            }, to);
-            board[to] = 10; // Black queen
-            pendingPromotionSquare = -1;
-            whiteToMove = !whiteToMove;
-        } else {
-            // White pawn (human) needs to choose
-            pendingPromotionSquare = to;
-        }
+    // Rejects invalid moves and moves that leave the king in check
+    Move move = legalMoveFor(from, to);
+    if (move == MOVE_NONE) return false;
+
+    MoveUndo undo;
+    if (isPromotion(move)) {
+        // The player picks the piece through promotePawn(); the pawn waits on the last rank until then
+        doMove(encodeMove(from, to, moveFlags(move) & MOVE_FLAG_CAPTURE), &undo);
+        pendingPromotionSquare = to;
+        pendingPromotionMove = move;
+        gameStateValid = false;
     } else {
-        // No promotion -> flip turn here
+        doMove(move, &undo);
         whiteToMove = !whiteToMove;
+        gameMoves.push_back(move);
+        positionChanged();
     }
     EM_ASM({
         console.log("Pending promotion square: " + $0);
     }, pendingPromotionSquare);
     return true;
 }
+
+// Plays a packed Move (see move.h) for the side to move, including the promotion piece
+extern "C" EMSCRIPTEN_KEEPALIVE bool playMove(int move) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    uint8_t piece = board[from];
+    if (piece == 0 || ((piece % 2) == 1) != whiteToMove) return false;
+
+    Move legal = legalMoveFor(from, to);
+    if (legal == MOVE_NONE) return false;
+    if (isPromotion(legal) ? !isPromotion(move) : legal != move) return false;
+    if (isPromotion(move) && isCapture(move) != isCapture(legal)) return false;
+
+    MoveUndo undo;
+    doMove(move, &undo);
+    pendingPromotionSquare = -1;
+    whiteToMove = !whiteToMove;
+    gameMoves.push_back(move);
+    positionChanged();
+    return true;
+}
                         
 extern "C" EMSCRIPTEN_KEEPALIVE int getPendingPromotionSquare() {
     return pendingPromotionSquare;
@@ -544,6 +794,11 @@ extern "C" EMSCRIPTEN_KEEPALIVE void promotePawn(int square, int newPieceCode) {
         board[square] = newPieceCode;
         pendingPromotionSquare = -1;
         whiteToMove = !whiteToMove;  // Switch turn after promotion is handled
+        // Knight, bishop, rook, queen codes map to promotion offsets 0-3
+        int promotion = (newPieceCode - 3) / 2;
+        gameMoves.push_back(encodeMove(moveFrom(pendingPromotionMove), square,
+                                       MOVE_FLAG_PROMOTION + promotion + (moveFlags(pendingPromotionMove) & MOVE_FLAG_CAPTURE)));
+        positionChanged();
         EM_ASM({
           console.log("Promoting at " + $0 + " to " + $1);
         }, index, newPieceCode);
@@ -551,9 +806,8 @@ extern "C" EMSCRIPTEN_KEEPALIVE void promotePawn(int square, int newPieceCode) {
     }
 }
     
-// Initialize board to standard chess starting position
-extern "C" EMSCRIPTEN_KEEPALIVE void initBoard() {
-    uint8_t initialBoard[64] = {
+void startingPosition(PositionSnapshot* snapshot) {
+    static const uint8_t initialBoard[64] = {
         7,3,5,9,11,5,3,7,
         1,1,1,1,1,1,1,1,
         0,0,0,0,0,0,0,0,
@@ -563,9 +817,45 @@ extern "C" EMSCRIPTEN_KEEPALIVE void initBoard() {
         2,2,2,2,2,2,2,2,
         8,4,6,10,12,6,4,8
     };
-    memcpy(board, initialBoard, 64);
-    whiteToMove = true;
-    enPassantTarget = -1;
+    memcpy(snapshot->board, initialBoard, 64);
+    snapshot->enPassantTarget = -1;
+    snapshot->hasWhiteKingMoved = false;
+    snapshot->hasBlackKingMoved = false;
+    snapshot->hasWhiteKingsideRookMoved = false;
+    snapshot->hasWhiteQueensideRookMoved = false;
+    snapshot->hasBlackKingsideRookMoved = false;
+    snapshot->hasBlackQueensideRookMoved = false;
+}
+
+void setGamePosition(const PositionSnapshot* position, bool white) {
+    loadPosition(position);
+    whiteToMove = white;
+    pendingPromotionSquare = -1;
+    pendingPromotionMove = MOVE_NONE;
+    gameStart = *position;
+    gameStartWhiteToMove = white;
+    gameMoves.clear();
+    gameCounter++;
+    positionHistory.clear();
+    positionChanged();
+}
+
+uint32_t gameNumber() {
+    return gameCounter;
+}
+
+int getGameMoves(const Move** moves, PositionSnapshot* start, bool* startWhite) {
+    *moves = gameMoves.data();
+    *start = gameStart;
+    *startWhite = gameStartWhiteToMove;
+    return (int)gameMoves.size();
+}
+
+// Initialize board to standard chess starting position
+extern "C" EMSCRIPTEN_KEEPALIVE void initBoard() {
+    PositionSnapshot start;
+    startingPosition(&start);
+    setGamePosition(&start, true);
 }
     
 // Get board pointer (for JS rendering)
@@ -580,5 +870,6 @@ extern "C" EMSCRIPTEN_KEEPALIVE int currentTurn() {
 
 extern "C" EMSCRIPTEN_KEEPALIVE void setCurrentTurn(int turn) {
     whiteToMove = (turn == 1);
+    positionChanged();
 }
 
@@ -2,13 +2,92 @@
 #define MAIN_H
 
 #include <stdint.h>
+#include "move.h"
+
+// Threaded builds give every search thread its own copy of the position state
+#ifdef ENGINE_THREADS
+#define POSITION_LOCAL thread_local
+#else
+#define POSITION_LOCAL
+#endif
 
 // Tell the compiler this is C-style linkage when included from C++ files
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-extern uint8_t board[64];
+extern POSITION_LOCAL uint8_t board[64];
+
+// Everything move generation depends on, so a search thread can take a copy
+struct PositionSnapshot {
+    uint8_t board[64];
+    int enPassantTarget;
+    bool hasWhiteKingMoved;
+    bool hasBlackKingMoved;
+    bool hasWhiteKingsideRookMoved;
+    bool hasWhiteQueensideRookMoved;
+    bool hasBlackKingsideRookMoved;
+    bool hasBlackQueensideRookMoved;
+};
+
+void savePosition(struct PositionSnapshot* snapshot);
+void loadPosition(const struct PositionSnapshot* snapshot);
+
+// State doMove() overwrites, so undoMove() can put it back
+struct MoveUndo {
+    uint8_t captured;
+    int enPassantTarget;
+    bool hasWhiteKingMoved;
+    bool hasBlackKingMoved;
+    bool hasWhiteKingsideRookMoved;
+    bool hasWhiteQueensideRookMoved;
+    bool hasBlackKingsideRookMoved;
+    bool hasBlackQueensideRookMoved;
+};
+
+// Search-side move making: updates board, en passant and castling state but not the game turn
+void doMove(Move move, struct MoveUndo* undo);
+void undoMove(Move move, const struct MoveUndo* undo);
+
+// Zobrist key of the current board with 'white' to move
+uint64_t positionKeyFor(bool white);
+
+// Fills 'moves' (room for MAX_LEGAL_MOVES) with the legal moves for one side; returns the count
+int generateLegalMoves(bool white, Move* moves);
+
+// The legal move from 'from' to 'to' (promotions as queen promotions), or MOVE_NONE
+Move legalMoveFor(int from, int to);
+bool hasLegalMoves(bool white);
+
+// ----- Game record -----
+void startingPosition(struct PositionSnapshot* snapshot);
+// Starts a new game from 'position' with 'white' to move (clears history and the move list)
+void setGamePosition(const struct PositionSnapshot* position, bool white);
+// Moves played since the game started from 'start'; returns the count
+int getGameMoves(const Move** moves, struct PositionSnapshot* start, bool* startWhite);
+// Identifies the current game: changes whenever setGamePosition() starts a new one
+uint32_t gameNumber();
+
+// Packed game state returned by getGameState():
+//   [0]    status flags (GAME_STATUS_*)
+//   [1]    side to move (1 = White, 2 = Black)
+//   [2]    king square of the side to move
+//   [3]    number of legal moves N
+//   [4..]  N Moves, 16-bit little-endian (see move.h)
+const uint8_t GAME_STATUS_CHECK                 = 1 << 0;
+const uint8_t GAME_STATUS_CHECKMATE             = 1 << 1;
+const uint8_t GAME_STATUS_STALEMATE             = 1 << 2;
+const uint8_t GAME_STATUS_INSUFFICIENT_MATERIAL = 1 << 3;
+const uint8_t GAME_STATUS_REPETITION            = 1 << 4;
+const int GAME_STATE_HEADER_SIZE = 4;
+const int MAX_LEGAL_MOVES = 256;
+
+void initBoard();
+uint8_t* getGameState();
+int getPendingPromotionSquare();
+void promotePawn(int square, int newPieceCode);
+int currentTurn();
+bool playMove(int move);
 
 bool isValidMove(int from, int to);
 bool wouldKingBeInCheckAfterMove(int from, int to);
@@ -0,0 +1,275 @@
+// Mate solver: depth-first proof-number search (df-pn).
+//
+// The side to move is the attacker. OR nodes are attacker moves (one proven
+// child proves the node), AND nodes defender moves (every child must be
+// proven). Proof and disproof numbers steer the search towards the cheapest
+// unresolved subtree, so a forced mate is usually proven after a small
+// fraction of the nodes a fixed-depth alpha-beta needs.
+//
+// Nodes are keyed on the position plus the plies left, so the ply limit never
+// mixes results from different depths and no search path can repeat a key.
+
+#include "engine.h"
+#include "main.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+const uint32_t PROOF_INFINITY = 1u << 30;
+const int MAX_MATE_PLIES = 63;
+const size_t MATE_TABLE_ENTRIES = 1 << 16; // 1.5 MB
+
+struct MateEntry {
+    uint64_t key;
+    uint32_t proof;    // Proof number: 0 = mate proven
+    uint32_t disproof; // Disproof number: 0 = no mate within the plies left
+    uint16_t distance; // Plies to mate once proven
+};
+
+static std::vector<MateEntry> mateTable(MATE_TABLE_ENTRIES);
+static uint64_t depthKeys[MAX_MATE_PLIES + 1];
+static long mateNodes = 0;
+static long mateNodeLimit = 0;
+
+// Mating line for findMate(): [count, move0, move1, ...]; count 0 = no mate found
+static int32_t mateLine[1 + MAX_MATE_PLIES];
+
+// Per-node move lists, indexed by plies left (unique along a search path). Kept
+// off the stack: a 63-ply search would otherwise need ~190 KB of recursion,
+// far over the browser build's 64 KB stack.
+struct MatePly {
+    Move moves[MAX_LEGAL_MOVES];
+    uint64_t childKeys[MAX_LEGAL_MOVES];
+    bool childPruned[MAX_LEGAL_MOVES];
+};
+static std::vector<MatePly> matePlies(MAX_MATE_PLIES + 1);
+
+static bool initDepthKeys() {
+    uint64_t seed = 0xD1B54A32D192ED03ULL;
+    for (int plies = 0; plies <= MAX_MATE_PLIES; ++plies) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        depthKeys[plies] = seed;
+    }
+    return true;
+}
+static bool depthKeysReady = initDepthKeys();
+
+static inline uint64_t mateKey(bool white, int plies) {
+    return positionKeyFor(white) ^ depthKeys[plies];
+}
+
+static bool mateLookup(uint64_t key, uint32_t& proof, uint32_t& disproof, int& distance) {
+    const MateEntry& entry = mateTable[key & (MATE_TABLE_ENTRIES - 1)];
+    if (entry.key != key) return false;
+    proof = entry.proof;
+    disproof = entry.disproof;
+    distance = entry.distance;
+    return true;
+}
+
+static void mateStore(uint64_t key, uint32_t proof, uint32_t disproof, int distance) {
+    MateEntry& entry = mateTable[key & (MATE_TABLE_ENTRIES - 1)];
+    entry.key = key;
+    entry.proof = proof;
+    entry.disproof = disproof;
+    entry.distance = distance;
+}
+
+static inline uint32_t addProof(uint32_t a, uint32_t b) {
+    return std::min(a + b, PROOF_INFINITY);
+}
+
+// Expands the node for 'white' to move with 'plies' left until its proof number
+// reaches proofLimit or its disproof number reaches disproofLimit (or the node
+// budget runs out), then stores it
+static void searchMate(bool white, bool attacking, int plies, uint32_t proofLimit, uint32_t disproofLimit) {
+    uint64_t key = mateKey(white, plies);
+    mateNodes++;
+
+    // The attacker has no plies left to give mate with
+    if (attacking && plies == 0) {
+        mateStore(key, PROOF_INFINITY, 0, 0);
+        return;
+    }
+
+    MatePly& node = matePlies[plies];
+    Move* moves = node.moves;
+    int moveCount = generateLegalMoves(white, moves);
+    if (moveCount == 0) {
+        if (!attacking && isInCheck(white)) mateStore(key, 0, PROOF_INFINITY, 0);
+        else mateStore(key, PROOF_INFINITY, 0, 0); // Stalemate, or the attacker is mated
+        return;
+    }
+    if (plies == 0) {
+        mateStore(key, PROOF_INFINITY, 0, 0); // The defender still has a move
+        return;
+    }
+
+    // Child keys once per node; on the attacker's last ply only checks can mate
+    uint64_t* childKeys = node.childKeys;
+    bool* childPruned = node.childPruned;
+    for (int i = 0; i < moveCount; ++i) {
+        MoveUndo undo;
+        doMove(moves[i], &undo);
+        childKeys[i] = mateKey(!white, plies - 1);
+        childPruned[i] = attacking && plies == 1 && !isInCheck(!white);
+        undoMove(moves[i], &undo);
+    }
+
+    for (;;) {
+        // Combine the children: OR = min proof / sum disproof, AND = sum proof / min disproof
+        uint32_t proof = attacking ? PROOF_INFINITY : 0;
+        uint32_t disproof = attacking ? 0 : PROOF_INFINITY;
+        uint32_t bestValue = PROOF_INFINITY, secondValue = PROOF_INFINITY;
+        int best = -1;
+        int distance = attacking ? MAX_MATE_PLIES : 0;
+
+        for (int i = 0; i < moveCount; ++i) {
+            uint32_t childProof = 1, childDisproof = 1;
+            int childDistance = 0;
+            if (childPruned[i]) {
+                childProof = PROOF_INFINITY;
+                childDisproof = 0;
+            } else {
+                mateLookup(childKeys[i], childProof, childDisproof, childDistance);
+            }
+
+            if (attacking) {
+                proof = std::min(proof, childProof);
+                disproof = addProof(disproof, childDisproof);
+                if (childProof == 0) distance = std::min(distance, childDistance + 1);
+            } else {
+                proof = addProof(proof, childProof);
+                disproof = std::min(disproof, childDisproof);
+                distance = std::max(distance, childDistance + 1);
+            }
+
+            // Most-proving child: smallest proof at OR nodes, smallest disproof at AND nodes
+            uint32_t value = attacking ? childProof : childDisproof;
+            if (value < bestValue) {
+                secondValue = bestValue;
+                bestValue = value;
+                best = i;
+            } else if (value < secondValue) {
+                secondValue = value;
+            }
+        }
+
+        if (proof >= proofLimit || disproof >= disproofLimit || mateNodes >= mateNodeLimit) {
+            mateStore(key, proof, disproof, distance);
+            return;
+        }
+
+        // Stay in the best child until it is no longer better than the runner-up
+        uint32_t childProof = 1, childDisproof = 1;
+        int childDistance = 0;
+        mateLookup(childKeys[best], childProof, childDisproof, childDistance);
+        uint32_t childProofLimit, childDisproofLimit;
+        if (attacking) {
+            childProofLimit = std::min(proofLimit, secondValue + 1);
+            childDisproofLimit = disproofLimit - disproof + childDisproof;
+        } else {
+            childProofLimit = proofLimit - proof + childProof;
+            childDisproofLimit = std::min(disproofLimit, secondValue + 1);
+        }
+
+        MoveUndo undo;
+        doMove(moves[best], &undo);
+        searchMate(!white, !attacking, plies - 1, childProofLimit, childDisproofLimit);
+        undoMove(moves[best], &undo);
+    }
+}
+
+// Proven node's result, searching it again if the table lost it
+static bool provenMate(bool white, bool attacking, int plies, int& distance) {
+    // Unknown-node values until a lookup hits
+    uint32_t proof = 1, disproof = 1;
+    distance = 0;
+    if (!mateLookup(mateKey(white, plies), proof, disproof, distance)) {
+        searchMate(white, attacking, plies, PROOF_INFINITY, PROOF_INFINITY);
+        mateLookup(mateKey(white, plies), proof, disproof, distance);
+    }
+    return proof == 0;
+}
+
+// Follows a proven root: the quickest mate for the attacker, the longest defence
+// for the defender. False if the line does not end in mate, which happens when
+// evicted entries cannot be proven again within the node budget.
+static bool extractMateLine(bool white, int plies, std::vector<Move>& line) {
+    std::vector<Move> moves(MAX_LEGAL_MOVES);
+    std::vector<MoveUndo> undos;
+    bool attacking = true;
+    bool mated = false;
+
+    for (; plies >= 0; --plies) {
+        int moveCount = generateLegalMoves(white, moves.data());
+        if (moveCount == 0) {
+            mated = !attacking && isInCheck(white);
+            break;
+        }
+
+        Move chosen = MOVE_NONE;
+        int chosenDistance = 0;
+        for (int i = 0; i < moveCount && plies > 0; ++i) {
+            MoveUndo undo;
+            doMove(moves[i], &undo);
+            int distance;
+            bool proven = provenMate(!white, !attacking, plies - 1, distance);
+            undoMove(moves[i], &undo);
+
+            if (!proven) continue;
+            if (chosen == MOVE_NONE || (attacking ? distance < chosenDistance : distance > chosenDistance)) {
+                chosen = moves[i];
+                chosenDistance = distance;
+            }
+        }
+        if (chosen == MOVE_NONE) break;
+
+        line.push_back(chosen);
+        undos.emplace_back();
+        doMove(chosen, &undos.back());
+        white = !white;
+        attacking = !attacking;
+    }
+
+    for (size_t i = line.size(); i-- > 0;) undoMove(line[i], &undos[i]);
+    if (!mated) line.clear();
+    return mated;
+}
+
+bool solveMate(bool white, int maxPlies, long nodeLimit, std::vector<Move>& line) {
+    line.clear();
+    maxPlies = std::min(maxPlies, MAX_MATE_PLIES);
+    std::fill(mateTable.begin(), mateTable.end(), MateEntry{});
+    mateNodes = 0;
+    mateNodeLimit = nodeLimit > 0 ? nodeLimit : PROOF_INFINITY;
+
+    // Mates are an odd number of plies; deepening one move at a time makes the first proof the shortest
+    for (int plies = 1; plies <= maxPlies; plies += 2) {
+        searchMate(white, true, plies, PROOF_INFINITY, PROOF_INFINITY);
+
+        uint32_t proof = 1, disproof = 1;
+        int distance = 0;
+        mateLookup(mateKey(white, plies), proof, disproof, distance);
+        if (proof == 0) return extractMateLine(white, plies, line);
+        if (mateNodes >= mateNodeLimit) break;
+    }
+    return false;
+}
+
+extern "C" {
+
+    // Mating line for the side to move within 'maxPlies' plies (mate in N = 2N - 1 plies),
+    // searching at most 'nodeLimit' nodes (0 = no limit). Returns mateLine (layout above) for HEAP32.
+    int32_t* findMate(int maxPlies, int nodeLimit) {
+        std::vector<Move> line;
+        solveMate(currentTurn() == 1, maxPlies, nodeLimit, line);
+
+        mateLine[0] = line.size();
+        for (size_t i = 0; i < line.size(); ++i) mateLine[1 + i] = line[i];
+        return mateLine;
+    }
+
+}
@@ -0,0 +1,40 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <stdint.h>
+
+// Packed move: bits 0-5 from square, bits 6-11 to square, bits 12-15 flags (MOVE_FLAG_*)
+typedef uint16_t Move;
+
+const Move MOVE_NONE = 0; // a1 -> a1 is never a legal move
+
+const int MOVE_FLAG_QUIET            = 0;
+const int MOVE_FLAG_DOUBLE_PAWN_PUSH = 1;
+const int MOVE_FLAG_KING_CASTLE      = 2;
+const int MOVE_FLAG_QUEEN_CASTLE     = 3;
+const int MOVE_FLAG_CAPTURE          = 4;
+const int MOVE_FLAG_EN_PASSANT       = 5;
+// Promotions: MOVE_FLAG_PROMOTION + 0..3 (knight, bishop, rook, queen), plus MOVE_FLAG_CAPTURE when capturing
+const int MOVE_FLAG_PROMOTION        = 8;
+
+inline Move encodeMove(int from, int to, int flags) {
+    return (Move)(from | (to << 6) | (flags << 12));
+}
+
+inline int moveFrom(Move move) { return move & 63; }
+inline int moveTo(Move move) { return (move >> 6) & 63; }
+inline int moveFlags(Move move) { return move >> 12; }
+
+inline bool isCapture(Move move) { return (moveFlags(move) & MOVE_FLAG_CAPTURE) != 0; }
+inline bool isPromotion(Move move) { return (moveFlags(move) & MOVE_FLAG_PROMOTION) != 0; }
+inline bool isCastle(Move move) {
+    return moveFlags(move) == MOVE_FLAG_KING_CASTLE || moveFlags(move) == MOVE_FLAG_QUEEN_CASTLE;
+}
+
+// Piece code (3-10) a promotion move creates for the given side
+inline uint8_t promotionPiece(Move move, bool white) {
+    static const uint8_t whitePieces[4] = {3, 5, 7, 9}; // Knight, Bishop, Rook, Queen
+    return whitePieces[moveFlags(move) & 3] + (white ? 0 : 1);
+}
+
+#endif // MOVE_H
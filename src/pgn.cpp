@@ -0,0 +1,647 @@
+#include "pgn.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Piece codes (see main.cpp) by FEN letter; index == code
+static const char FEN_PIECES[] = " PpNnBbRrQqKk";
+// SAN letters by piece type (pawn, knight, bishop, rook, queen, king)
+static const char SAN_PIECES[] = "PNBRQK";
+// Promotion pieces in move flag order (see move.h)
+static const char PROMOTION_PIECES[] = "NBRQ";
+
+// Position of 'c' in 'letters', or -1
+static inline int letterIndex(const char* letters, char c) {
+    const char* found = strchr(letters, c);
+    return (c != '\0' && found) ? (int)(found - letters) : -1;
+}
+
+static inline uint8_t pieceCode(int type, bool white) {
+    return 1 + type * 2 + (white ? 0 : 1);
+}
+
+static inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// ----- FEN -----
+
+bool parseFEN(const char* fen, size_t length, PositionSnapshot& position, bool& white) {
+    const char* p = fen;
+    const char* end = fen + length;
+    memset(&position, 0, sizeof(position));
+
+    while (p < end && isBlank(*p)) p++;
+    int rank = 7, file = 0;
+    for (; p < end && *p != ' '; ++p) {
+        char c = *p;
+        if (c == '/') {
+            if (file != 8 || rank == 0) return false;
+            rank--;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) return false;
+        } else {
+            int piece = letterIndex(FEN_PIECES, c);
+            if (piece < 1 || file >= 8) return false;
+            position.board[rank * 8 + file++] = piece;
+        }
+    }
+    if (rank != 0 || file != 8) return false;
+
+    int whiteKings = 0, blackKings = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (position.board[sq] == 11) whiteKings++;
+        if (position.board[sq] == 12) blackKings++;
+    }
+    if (whiteKings != 1 || blackKings != 1) return false;
+
+    while (p < end && *p == ' ') p++;
+    if (p == end || (*p != 'w' && *p != 'b')) return false;
+    white = *p++ == 'w';
+
+    // Castling field
+    while (p < end && *p == ' ') p++;
+    bool K = false, Q = false, k = false, q = false;
+    for (; p < end && *p != ' '; ++p) {
+        switch (*p) {
+            case 'K': K = true; break;
+            case 'Q': Q = true; break;
+            case 'k': k = true; break;
+            case 'q': q = true; break;
+            case '-': break;
+            default: return false;
+        }
+    }
+    const uint8_t* b = position.board;
+    K = K && b[4] == 11 && b[7] == 7;
+    Q = Q && b[4] == 11 && b[0] == 7;
+    k = k && b[60] == 12 && b[63] == 8;
+    q = q && b[60] == 12 && b[56] == 8;
+    position.hasWhiteKingMoved = !K && !Q;
+    position.hasWhiteKingsideRookMoved = !K;
+    position.hasWhiteQueensideRookMoved = !Q;
+    position.hasBlackKingMoved = !k && !q;
+    position.hasBlackKingsideRookMoved = !k;
+    position.hasBlackQueensideRookMoved = !q;
+
+    // En passant field (optional, as are the clocks after it)
+    position.enPassantTarget = -1;
+    while (p < end && *p == ' ') p++;
+    if (p < end && *p != '-') {
+        if (end - p < 2 || p[0] < 'a' || p[0] > 'h' || (p[1] != '3' && p[1] != '6')) return false;
+        position.enPassantTarget = (p[1] - '1') * 8 + (p[0] - 'a');
+    }
+    return true;
+}
+
+void formatFEN(const PositionSnapshot& position, bool white, char out[FEN_MAX_LENGTH]) {
+    char* p = out;
+    for (int rank = 7; rank >= 0; --rank) {
+        int empty = 0;
+        for (int file = 0; file < 8; ++file) {
+            uint8_t piece = position.board[rank * 8 + file];
+            if (piece == 0) {
+                empty++;
+                continue;
+            }
+            if (empty) *p++ = '0' + empty;
+            empty = 0;
+            *p++ = FEN_PIECES[piece];
+        }
+        if (empty) *p++ = '0' + empty;
+        if (rank > 0) *p++ = '/';
+    }
+    *p++ = ' ';
+    *p++ = white ? 'w' : 'b';
+    *p++ = ' ';
+
+    char* castling = p;
+    if (!position.hasWhiteKingMoved && !position.hasWhiteKingsideRookMoved) *p++ = 'K';
+    if (!position.hasWhiteKingMoved && !position.hasWhiteQueensideRookMoved) *p++ = 'Q';
+    if (!position.hasBlackKingMoved && !position.hasBlackKingsideRookMoved) *p++ = 'k';
+    if (!position.hasBlackKingMoved && !position.hasBlackQueensideRookMoved) *p++ = 'q';
+    if (p == castling) *p++ = '-';
+    *p++ = ' ';
+
+    if (position.enPassantTarget == -1) {
+        *p++ = '-';
+    } else {
+        *p++ = 'a' + position.enPassantTarget % 8;
+        *p++ = '1' + position.enPassantTarget / 8;
+    }
+    // The engine keeps no clocks
+    strcpy(p, " 0 1");
+}
+
+// ----- SAN -----
+
+Move parseSAN(const char* san, size_t length, bool white) {
+    // Check, mate and annotation suffixes carry no move information
+    while (length > 0 && letterIndex("+#!?", san[length - 1]) != -1) length--;
+    if (length < 2) return MOVE_NONE;
+
+    if (san[0] == 'O' || san[0] == '0') {
+        int from = white ? 4 : 60;
+        int to;
+        if (length == 3 && san[1] == '-' && san[2] == san[0]) to = from + 2;
+        else if (length == 5 && san[1] == '-' && san[2] == san[0] && san[3] == '-' && san[4] == san[0]) to = from - 2;
+        else return MOVE_NONE;
+        if (board[from] != pieceCode(5, white)) return MOVE_NONE;
+        Move move = legalMoveFor(from, to);
+        return isCastle(move) ? move : MOVE_NONE;
+    }
+
+    // Promotion piece, written "e8=Q" or "e8Q"
+    int promotion = length >= 3 ? letterIndex(PROMOTION_PIECES, san[length - 1]) : -1;
+    if (promotion != -1) {
+        length--;
+        if (san[length - 1] == '=') length--;
+    }
+    if (length < 2) return MOVE_NONE;
+
+    int toFile = san[length - 2] - 'a';
+    int toRank = san[length - 1] - '1';
+    if (toFile < 0 || toFile > 7 || toRank < 0 || toRank > 7) return MOVE_NONE;
+    int to = toRank * 8 + toFile;
+
+    // No piece letter means a pawn
+    int type = letterIndex(SAN_PIECES, san[0]);
+    size_t i = 1;
+    if (type == -1) {
+        type = 0;
+        i = 0;
+    }
+
+    int fromFile = -1, fromRank = -1;
+    bool capture = false;
+    for (; i < length - 2; ++i) {
+        char c = san[i];
+        if (c >= 'a' && c <= 'h') fromFile = c - 'a';
+        else if (c >= '1' && c <= '8') fromRank = c - '1';
+        else if (c == 'x' || c == ':') capture = true;
+        else if (c != '-') return MOVE_NONE;
+    }
+    // A pawn that does not capture stays on its file
+    if (type == 0 && !capture && fromFile == -1) fromFile = toFile;
+
+    // Only pieces of the named type can make the move
+    uint8_t piece = pieceCode(type, white);
+    Move found = MOVE_NONE;
+    for (int from = 0; from < 64; ++from) {
+        if (board[from] != piece) continue;
+        if (fromFile != -1 && from % 8 != fromFile) continue;
+        if (fromRank != -1 && from / 8 != fromRank) continue;
+
+        Move move = legalMoveFor(from, to);
+        if (move == MOVE_NONE) continue;
+        if (found != MOVE_NONE) return MOVE_NONE; // Ambiguous
+        found = move;
+    }
+    if (found == MOVE_NONE) return MOVE_NONE;
+
+    if (isPromotion(found)) {
+        // legalMoveFor() gives the queen promotion; a missing piece letter means a queen too
+        if (promotion != -1) {
+            found = encodeMove(moveFrom(found), to,
+                               MOVE_FLAG_PROMOTION + promotion + (moveFlags(found) & MOVE_FLAG_CAPTURE));
+        }
+    } else if (promotion != -1) {
+        return MOVE_NONE;
+    }
+    return found;
+}
+
+int formatSAN(Move move, char out[SAN_MAX_LENGTH]) {
+    int from = moveFrom(move);
+    int to = moveTo(move);
+    int flags = moveFlags(move);
+    uint8_t piece = board[from];
+    bool white = (piece % 2) == 1;
+    int type = (piece - 1) / 2;
+    char* p = out;
+
+    if (flags == MOVE_FLAG_KING_CASTLE) {
+        strcpy(p, "O-O");
+        p += 3;
+    } else if (flags == MOVE_FLAG_QUEEN_CASTLE) {
+        strcpy(p, "O-O-O");
+        p += 5;
+    } else {
+        bool capture = isCapture(move) || flags == MOVE_FLAG_EN_PASSANT;
+        if (type == 0) {
+            if (capture) *p++ = 'a' + from % 8;
+        } else {
+            *p++ = SAN_PIECES[type];
+
+            // Disambiguate against other pieces of the same type reaching 'to'
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (int other = 0; other < 64; ++other) {
+                if (other == from || board[other] != piece) continue;
+                if (legalMoveFor(other, to) == MOVE_NONE) continue;
+                ambiguous = true;
+                if (other % 8 == from % 8) sameFile = true;
+                if (other / 8 == from / 8) sameRank = true;
+            }
+            if (ambiguous) {
+                if (!sameFile) {
+                    *p++ = 'a' + from % 8;
+                } else if (!sameRank) {
+                    *p++ = '1' + from / 8;
+                } else {
+                    *p++ = 'a' + from % 8;
+                    *p++ = '1' + from / 8;
+                }
+            }
+        }
+        if (capture) *p++ = 'x';
+        *p++ = 'a' + to % 8;
+        *p++ = '1' + to / 8;
+        if (isPromotion(move)) {
+            *p++ = '=';
+            *p++ = PROMOTION_PIECES[flags & 3];
+        }
+    }
+
+    MoveUndo undo;
+    doMove(move, &undo);
+    if (isInCheck(!white)) *p++ = hasLegalMoves(!white) ? '+' : '#';
+    undoMove(move, &undo);
+
+    *p = '\0';
+    return p - out;
+}
+
+// ----- Reading -----
+
+bool pgnOpenFile(PgnReader& reader, const char* path) {
+    pgnOpenBuffer(reader, nullptr, 0);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return true; // An empty database has no games
+    }
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) return false;
+#ifdef MADV_SEQUENTIAL
+    madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+#endif
+
+    reader.data = (const char*)mapping;
+    reader.size = st.st_size;
+    reader.mapping = mapping;
+    return true;
+}
+
+void pgnOpenBuffer(PgnReader& reader, const char* text, size_t length) {
+    reader.data = text;
+    reader.size = length;
+    reader.offset = 0;
+    reader.mapping = nullptr;
+}
+
+void pgnClose(PgnReader& reader) {
+    if (reader.mapping) munmap(reader.mapping, reader.size);
+    pgnOpenBuffer(reader, nullptr, 0);
+}
+
+enum PgnToken { PGN_TOKEN_END, PGN_TOKEN_MOVE, PGN_TOKEN_RESULT };
+
+// Ends a SAN or result token
+static inline bool isDelimiter(char c) {
+    return isBlank(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == ';' || c == '$';
+}
+
+// True if [p, end) starts with the whole token 'text'
+static bool startsToken(const char* p, const char* end, const char* text) {
+    size_t length = strlen(text);
+    if ((size_t)(end - p) < length || memcmp(p, text, length) != 0) return false;
+    return p + length == end || isDelimiter(p[length]);
+}
+
+static const char* skipComment(const char* p, const char* end) {
+    while (p < end && *p != '}') p++;
+    return p < end ? p + 1 : end;
+}
+
+static const char* skipLine(const char* p, const char* end) {
+    while (p < end && *p != '\n') p++;
+    return p;
+}
+
+// Next SAN move or result in movetext, skipping move numbers, comments,
+// variations and NAGs. Stops (without consuming) at the '[' of the next
+// game's tags.
+static PgnToken nextToken(const char*& p, const char* end, const char*& token, size_t& length) {
+    int variationDepth = 0;
+    while (p < end) {
+        char c = *p;
+        if (isBlank(c) || c == ')' || c == '}' || c == '.') {
+            if (c == ')' && variationDepth > 0) variationDepth--;
+            p++;
+        } else if (c == '$') {
+            // Numeric annotation glyph
+            p++;
+            while (p < end && *p >= '0' && *p <= '9') p++;
+        } else if (c == '{') {
+            p = skipComment(p + 1, end);
+        } else if (c == ';' || c == '%') {
+            p = skipLine(p, end);
+        } else if (c == '(') {
+            variationDepth++;
+            p++;
+        } else if (c == '[' && variationDepth == 0) {
+            return PGN_TOKEN_END;
+        } else {
+            const char* start = p;
+            bool result = startsToken(p, end, "1-0") || startsToken(p, end, "0-1") ||
+                          startsToken(p, end, "1/2-1/2") || startsToken(p, end, "*");
+            bool castling = c == '0' && end - p > 1 && p[1] == '-';
+            if (!result && !castling && c >= '0' && c <= '9') {
+                // Move number; "1.e4" continues with the move itself
+                while (p < end && *p >= '0' && *p <= '9') p++;
+                continue;
+            }
+            while (p < end && !isDelimiter(*p)) p++;
+            if (variationDepth > 0) continue;
+            token = start;
+            length = p - start;
+            return result ? PGN_TOKEN_RESULT : PGN_TOKEN_MOVE;
+        }
+    }
+    return PGN_TOKEN_END;
+}
+
+bool pgnNextGame(PgnReader& reader, PgnGame& game) {
+    const char* p = reader.data + reader.offset;
+    const char* end = reader.data + reader.size;
+
+    game.tags.clear();
+    game.movetext = nullptr;
+    game.movetextLength = 0;
+    game.result = nullptr;
+    game.resultLength = 0;
+
+    // Tag pairs: [Name "Value"]
+    for (;;) {
+        while (p < end && isBlank(*p)) p++;
+        if (p == end || *p != '[') break;
+
+        p++;
+        const char* lineEnd = skipLine(p, end);
+        while (p < lineEnd && *p == ' ') p++;
+        PgnTag tag = {};
+        tag.name = p;
+        while (p < lineEnd && *p != ' ' && *p != '"' && *p != ']') p++;
+        tag.nameLength = p - tag.name;
+        while (p < lineEnd && *p != '"') p++;
+        if (p < lineEnd && tag.nameLength > 0) {
+            tag.value = ++p;
+            while (p < lineEnd && *p != '"') p += (*p == '\\' && p + 1 < lineEnd) ? 2 : 1;
+            tag.valueLength = p - tag.value;
+            game.tags.push_back(tag);
+        }
+        p = lineEnd;
+    }
+
+    game.movetext = p;
+    const char* token;
+    size_t length;
+    PgnToken kind;
+    while ((kind = nextToken(p, end, token, length)) == PGN_TOKEN_MOVE) {}
+    game.movetextLength = p - game.movetext;
+    if (kind == PGN_TOKEN_RESULT) {
+        game.result = token;
+        game.resultLength = length;
+    }
+
+    reader.offset = p - reader.data;
+    return !game.tags.empty() || kind != PGN_TOKEN_END || game.movetextLength > 0;
+}
+
+const PgnTag* pgnFindTag(const PgnGame& game, const char* name) {
+    size_t nameLength = strlen(name);
+    for (const PgnTag& tag : game.tags) {
+        if (tag.nameLength == nameLength && memcmp(tag.name, name, nameLength) == 0) return &tag;
+    }
+    return nullptr;
+}
+
+bool pgnStartPosition(const PgnGame& game, PositionSnapshot& position, bool& white) {
+    const PgnTag* fen = pgnFindTag(game, "FEN");
+    if (fen) return parseFEN(fen->value, fen->valueLength, position, white);
+    startingPosition(&position);
+    white = true;
+    return true;
+}
+
+int pgnReplayGame(const PgnGame& game, bool& white, PgnMoveVisitor visit, void* context) {
+    PositionSnapshot start;
+    if (!pgnStartPosition(game, start, white)) return -1;
+    loadPosition(&start);
+
+    const char* p = game.movetext;
+    const char* end = game.movetext + game.movetextLength;
+    const char* token;
+    size_t length;
+    int played = 0;
+    while (nextToken(p, end, token, length) == PGN_TOKEN_MOVE) {
+        Move move = parseSAN(token, length, white);
+        if (move == MOVE_NONE) return -1;
+        if (visit) visit(move, token, length, white, context);
+
+        MoveUndo undo;
+        doMove(move, &undo);
+        white = !white;
+        played++;
+    }
+    return played;
+}
+
+// ----- Writing -----
+
+static void appendTag(std::string& out, const std::string& name, const std::string& value) {
+    out += '[';
+    out += name;
+    out += " \"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    out += "\"]\n";
+}
+
+std::string pgnWriteGame(const std::vector<std::pair<std::string, std::string>>& tags,
+                         const PositionSnapshot& start, bool startWhite,
+                         const Move* moves, int moveCount, const char* result) {
+    std::string out;
+    for (const auto& tag : tags) appendTag(out, tag.first, tag.second);
+
+    char fen[FEN_MAX_LENGTH], standardFen[FEN_MAX_LENGTH];
+    PositionSnapshot standard;
+    startingPosition(&standard);
+    formatFEN(start, startWhite, fen);
+    formatFEN(standard, true, standardFen);
+    if (strcmp(fen, standardFen) != 0) {
+        appendTag(out, "SetUp", "1");
+        appendTag(out, "FEN", fen);
+    }
+    out += '\n';
+
+    // SAN needs each move's position; the caller's board is put back afterwards
+    PositionSnapshot saved;
+    savePosition(&saved);
+    loadPosition(&start);
+
+    bool white = startWhite;
+    size_t lineStart = out.size();
+    auto appendWord = [&](const char* word) {
+        size_t length = strlen(word);
+        if (out.size() > lineStart && out.size() - lineStart + 1 + length > 80) {
+            out += '\n';
+            lineStart = out.size();
+        } else if (out.size() > lineStart) {
+            out += ' ';
+        }
+        out += word;
+    };
+
+    for (int i = 0; i < moveCount; ++i) {
+        // A move number stays on the line of its move
+        char word[32] = "";
+        if (white || i == 0) snprintf(word, sizeof(word), white ? "%d. " : "%d... ", i / 2 + 1);
+        formatSAN(moves[i], word + strlen(word));
+        appendWord(word);
+
+        MoveUndo undo;
+        doMove(moves[i], &undo);
+        white = !white;
+    }
+    appendWord(result);
+    out += '\n';
+
+    loadPosition(&saved);
+    return out;
+}
+
+// ----- Game record -----
+// Tag pairs and termination of the last importPGN() game, written back by
+// exportPGN() for as long as that game is the one being played
+static std::vector<std::pair<std::string, std::string>> importedTags;
+static std::string importedResult;
+static uint32_t importedGame = 0; // gameNumber() after the import, 0 = none
+static int importedMoveCount = 0;
+
+// The Seven Tag Roster, in its required order, with the values for unknown fields
+static const std::pair<const char*, const char*> ROSTER_TAGS[] = {
+    {"Event", "Casual game"}, {"Site", "?"}, {"Date", "????.??.??"}, {"Round", "-"},
+    {"White", "?"}, {"Black", "?"}, {"Result", "*"}
+};
+const int ROSTER_TAG_COUNT = sizeof(ROSTER_TAGS) / sizeof(ROSTER_TAGS[0]);
+
+static std::string unescapeTagValue(const PgnTag& tag) {
+    std::string value;
+    for (size_t i = 0; i < tag.valueLength; ++i) {
+        if (tag.value[i] == '\\' && i + 1 < tag.valueLength) i++;
+        value += tag.value[i];
+    }
+    return value;
+}
+
+extern "C" {
+
+    bool loadFEN(const char* fen) {
+        PositionSnapshot position;
+        bool white;
+        if (!parseFEN(fen, strlen(fen), position, white)) return false;
+        setGamePosition(&position, white);
+        return true;
+    }
+
+    bool importPGN(const char* text) {
+        PgnReader reader;
+        PgnGame game;
+        pgnOpenBuffer(reader, text, strlen(text));
+        if (!pgnNextGame(reader, game)) return false;
+
+        // Replay once on the side to check every move before the game is replaced
+        PositionSnapshot saved;
+        savePosition(&saved);
+        std::vector<Move> moves;
+        bool white;
+        int played = pgnReplayGame(game, white,
+                                   [](Move move, const char*, size_t, bool, void* context) {
+                                       ((std::vector<Move>*)context)->push_back(move);
+                                   },
+                                   &moves);
+        loadPosition(&saved);
+        if (played < 0) return false;
+
+        PositionSnapshot start;
+        pgnStartPosition(game, start, white);
+        setGamePosition(&start, white);
+        for (Move move : moves) playMove(move);
+
+        // SetUp/FEN and Result are written from the game itself on export
+        importedTags.clear();
+        for (const PgnTag& tag : game.tags) {
+            std::string name(tag.name, tag.nameLength);
+            if (name == "SetUp" || name == "FEN" || name == "Result") continue;
+            importedTags.emplace_back(name, unescapeTagValue(tag));
+        }
+        importedResult = game.result ? std::string(game.result, game.resultLength) : "*";
+        importedGame = gameNumber();
+        importedMoveCount = (int)moves.size();
+        return true;
+    }
+
+    const char* exportPGN() {
+        static std::string pgn;
+
+        const Move* moves;
+        PositionSnapshot start;
+        bool startWhite;
+        int moveCount = getGameMoves(&moves, &start, &startWhite);
+
+        uint8_t status = getGameState()[0];
+        const char* result = "*";
+        if (status & GAME_STATUS_CHECKMATE) {
+            result = currentTurn() == 1 ? "0-1" : "1-0";
+        } else if (status & (GAME_STATUS_STALEMATE | GAME_STATUS_INSUFFICIENT_MATERIAL | GAME_STATUS_REPETITION)) {
+            result = "1/2-1/2";
+        }
+
+        std::vector<std::pair<std::string, std::string>> tags(ROSTER_TAGS, ROSTER_TAGS + ROSTER_TAG_COUNT);
+        if (importedGame != 0 && importedGame == gameNumber()) {
+            // A position that looks unfinished keeps the imported result (resignation,
+            // agreed draw) until another move is played
+            if (strcmp(result, "*") == 0 && moveCount == importedMoveCount) result = importedResult.c_str();
+
+            // Imported values fill in the roster; other tags follow it in their original order
+            for (const auto& tag : importedTags) {
+                auto roster = std::find_if(tags.begin(), tags.begin() + ROSTER_TAG_COUNT,
+                                           [&](const std::pair<std::string, std::string>& t) { return t.first == tag.first; });
+                if (roster != tags.begin() + ROSTER_TAG_COUNT) roster->second = tag.second;
+                else tags.push_back(tag);
+            }
+        }
+        tags[ROSTER_TAG_COUNT - 1].second = result;
+
+        pgn = pgnWriteGame(tags, start, startWhite, moves, moveCount, result);
+        return pgn.c_str();
+    }
+
+}
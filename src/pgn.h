@@ -0,0 +1,97 @@
+#ifndef PGN_H
+#define PGN_H
+
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "main.h"
+#include "move.h"
+
+// PGN import/export on top of the legal move generator.
+//
+// PgnReader walks a memory-mapped file (or any buffer) one game at a time
+// without copying it: tags and movetext point straight into the mapping, so
+// a database is never loaded as a whole. Replay parses SAN by probing only the
+// pieces of the named type against the target square and plays moves with
+// doMove(), which keeps it to a few legality checks per move.
+
+// Longest FEN formatFEN() writes, including the terminating NUL
+const int FEN_MAX_LENGTH = 96;
+// Longest SAN formatSAN() writes ("Qa1xb2#" / "exd8=Q+"), including the NUL
+const int SAN_MAX_LENGTH = 8;
+
+// ----- FEN -----
+// Clocks are accepted but ignored; castling rights whose king or rook is not
+// on its home square are dropped
+bool parseFEN(const char* fen, size_t length, PositionSnapshot& position, bool& white);
+void formatFEN(const PositionSnapshot& position, bool white, char out[FEN_MAX_LENGTH]);
+
+// ----- SAN (for the current board) -----
+// Returns MOVE_NONE unless 'san' names exactly one legal move for 'white'.
+// Accepts check/annotation suffixes, 0-0 castling and promotions without '='.
+Move parseSAN(const char* san, size_t length, bool white);
+// Writes the SAN of legal move 'move', with + or # suffix; returns its length
+int formatSAN(Move move, char out[SAN_MAX_LENGTH]);
+
+// ----- Reading -----
+struct PgnTag {
+    const char* name;
+    size_t nameLength;
+    const char* value; // Still escaped (\" and \\)
+    size_t valueLength;
+};
+
+struct PgnGame {
+    std::vector<PgnTag> tags;
+    const char* movetext;
+    size_t movetextLength;
+    const char* result; // Termination token ("1-0", "0-1", "1/2-1/2", "*"), nullptr if missing
+    size_t resultLength;
+};
+
+struct PgnReader {
+    const char* data;
+    size_t size;
+    size_t offset;
+    void* mapping; // Set when the reader owns an mmap'ed file
+};
+
+bool pgnOpenFile(PgnReader& reader, const char* path);
+void pgnOpenBuffer(PgnReader& reader, const char* text, size_t length);
+void pgnClose(PgnReader& reader);
+// Reads the next game; false at the end of the input. 'game' is reused between calls.
+bool pgnNextGame(PgnReader& reader, PgnGame& game);
+
+const PgnTag* pgnFindTag(const PgnGame& game, const char* name);
+// The game's start position: its FEN tag, else the standard start
+bool pgnStartPosition(const PgnGame& game, PositionSnapshot& position, bool& white);
+
+// Called with each move before it is made; 'san' is the token as written
+typedef void (*PgnMoveVisitor)(Move move, const char* san, size_t sanLength, bool white, void* context);
+
+// Plays the game on the search-side position (loadPosition/doMove; the game
+// turn and history are left alone). 'white' ends as the side to move. Returns
+// the number of moves played, or -1 at the first SAN that is not a legal move,
+// leaving the board before it.
+int pgnReplayGame(const PgnGame& game, bool& white, PgnMoveVisitor visit = nullptr, void* context = nullptr);
+
+// ----- Writing -----
+// Tags are written in the given order, followed by SetUp/FEN when 'start' is
+// not the standard start position, then the movetext wrapped at 80 columns
+std::string pgnWriteGame(const std::vector<std::pair<std::string, std::string>>& tags,
+                         const PositionSnapshot& start, bool startWhite,
+                         const Move* moves, int moveCount, const char* result);
+
+extern "C" {
+    // Starts a new game from a FEN string; false (game untouched) if it does not parse
+    bool loadFEN(const char* fen);
+    // Replaces the game with the first game in 'text'; false (game untouched) if any move is illegal.
+    // Its tag pairs and result are kept for exportPGN() until the next new game.
+    bool importPGN(const char* text);
+    // PGN of the game so far, with the imported tags and result if it came from importPGN()
+    // (the result only while no move has been played since); valid until the next call
+    const char* exportPGN();
+}
+
+#endif // PGN_H
@@ -0,0 +1,176 @@
+#include "engine.h"
+#include "main.h"
+#include <algorithm>
+
+// Resumable version of findBestMove for single-threaded builds.
+//
+// The recursion of minimax() is kept on an explicit stack of frames so the
+// search can stop after a node budget and pick up where it left off. Between
+// steps every move on the current path is undone, so the game position is
+// untouched while the page renders; the next step replays the path first.
+// Move order and pruning match minimax() without the transposition table
+// (frames cannot be shared between steps and hash cutoffs safely).
+
+const int MAX_STEP_SEARCH_DEPTH = 16;
+
+struct SearchFrame {
+    Move moves[MAX_LEGAL_MOVES];
+    int moveCount;
+    int next;          // Index of the next move to search
+    int depth;         // Plies left below this frame, as minimax's 'depth'
+    int alpha;
+    int beta;
+    int bestScore;
+    bool maximizing;   // White to move at this frame
+    Move current;      // Move being searched below this frame
+    MoveUndo undo;
+};
+
+enum StepSearchState { STEP_IDLE, STEP_RUNNING, STEP_DONE };
+
+static SearchFrame frames[MAX_STEP_SEARCH_DEPTH + 2];
+static int framePly = 0; // frames[0..framePly] are live; frames[0] is the root
+static StepSearchState stepState = STEP_IDLE;
+static Move stepBestMove = MOVE_NONE;
+
+// Sets up frames[ply] the way minimax() starts a node, or returns false with
+// 'leafScore' set when the node has no children to search
+static bool enterNode(int ply, int depth, int alpha, int beta, bool maximizing, int& leafScore) {
+    if (depth == 0) {
+        leafScore = evaluateBoard();
+        return false;
+    }
+
+    SearchFrame& frame = frames[ply];
+    frame.moveCount = generateLegalMoves(maximizing, frame.moves);
+    if (frame.moveCount == 0) {
+        bool inCheck = isInCheck(maximizing);
+        leafScore = inCheck ? (maximizing ? -1000000 : 1000000) : 0;
+        return false;
+    }
+
+    // Same ordering as minimax()
+    int scores[MAX_LEGAL_MOVES];
+    int order[MAX_LEGAL_MOVES];
+    for (int i = 0; i < frame.moveCount; ++i) {
+        scores[i] = scoreMove(frame.moves[i]);
+        order[i] = i;
+    }
+    std::sort(order, order + frame.moveCount, [&scores](int a, int b) {
+        return scores[a] > scores[b];
+    });
+    Move sorted[MAX_LEGAL_MOVES];
+    for (int i = 0; i < frame.moveCount; ++i) sorted[i] = frame.moves[order[i]];
+    std::copy(sorted, sorted + frame.moveCount, frame.moves);
+
+    frame.next = 0;
+    frame.depth = depth;
+    frame.alpha = alpha;
+    frame.beta = beta;
+    frame.bestScore = maximizing ? -1000000 : 1000000;
+    frame.maximizing = maximizing;
+    return true;
+}
+
+// Feeds a child's score back into frames[ply]
+static void childReturned(int ply, int score) {
+    SearchFrame& frame = frames[ply];
+
+    if (ply == 0) {
+        // Root: every move gets a full window; keep the first strictly best one
+        if ((frame.maximizing && score > frame.bestScore) || (!frame.maximizing && score < frame.bestScore)) {
+            frame.bestScore = score;
+            stepBestMove = frame.current;
+        }
+        return;
+    }
+
+    if (frame.maximizing) {
+        frame.bestScore = std::max(frame.bestScore, score);
+        frame.alpha = std::max(frame.alpha, score);
+    } else {
+        frame.bestScore = std::min(frame.bestScore, score);
+        frame.beta = std::min(frame.beta, score);
+    }
+}
+
+extern "C" {
+
+    // Starts a search for the side to move; same depth meaning as findBestMove()
+    void searchStart(int depth) {
+        depth = std::max(0, std::min(depth, MAX_STEP_SEARCH_DEPTH));
+        bool white = currentTurn() == 1;
+        SearchFrame& root = frames[0];
+
+        framePly = 0;
+        stepBestMove = MOVE_NONE;
+        root.moveCount = generateLegalMoves(white, root.moves);
+        root.next = 0;
+        root.depth = depth + 1;
+        root.alpha = -1000000;
+        root.beta = 1000000;
+        root.bestScore = white ? -1000000 : 1000000;
+        root.maximizing = white;
+        stepState = (root.moveCount == 0) ? STEP_DONE : STEP_RUNNING;
+    }
+
+    // Searches about 'nodeBudget' more nodes; returns 1 once the search has finished
+    int searchStep(int nodeBudget) {
+        if (stepState != STEP_RUNNING) return 1;
+
+        // Replay the path to where the last step stopped
+        for (int ply = 0; ply < framePly; ++ply) {
+            doMove(frames[ply].current, &frames[ply].undo);
+        }
+
+        int nodes = 0;
+        while (nodes < nodeBudget) {
+            SearchFrame& frame = frames[framePly];
+            bool cutoff = framePly > 0 && frame.beta <= frame.alpha;
+
+            if (frame.next < frame.moveCount && !cutoff) {
+                frame.current = frame.moves[frame.next++];
+                doMove(frame.current, &frame.undo);
+                nodes++;
+
+                int childAlpha = (framePly == 0) ? -1000000 : frame.alpha;
+                int childBeta = (framePly == 0) ? 1000000 : frame.beta;
+                int leafScore = 0;
+                if (enterNode(framePly + 1, frame.depth - 1, childAlpha, childBeta, !frame.maximizing, leafScore)) {
+                    framePly++;
+                } else {
+                    undoMove(frame.current, &frame.undo);
+                    childReturned(framePly, leafScore);
+                }
+                continue;
+            }
+
+            // All moves searched (or cut off)
+            if (framePly == 0) {
+                if (stepBestMove == MOVE_NONE) stepBestMove = frame.moves[0];
+                stepState = STEP_DONE;
+                break;
+            }
+            int score = frame.bestScore;
+            framePly--;
+            undoMove(frames[framePly].current, &frames[framePly].undo);
+            childReturned(framePly, score);
+        }
+
+        // Leave the game position as it was
+        for (int ply = framePly - 1; ply >= 0; --ply) {
+            undoMove(frames[ply].current, &frames[ply].undo);
+        }
+        return stepState == STEP_DONE ? 1 : 0;
+    }
+
+    int searchResult() {
+        return stepState == STEP_DONE ? stepBestMove : MOVE_NONE;
+    }
+
+    void searchCancel() {
+        stepState = STEP_IDLE;
+        framePly = 0;
+    }
+
+}
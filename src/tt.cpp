@@ -0,0 +1,306 @@
+#include "tt.h"
+#include "eval_params.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The table lives either in localTable or in a POSIX shared-memory mapping
+static std::vector<TTEntry> localTable(TT_DEFAULT_ENTRIES);
+static TTEntry* table = localTable.data();
+static size_t tableEntries = TT_DEFAULT_ENTRIES;
+static size_t tableMask = TT_DEFAULT_ENTRIES - 1;
+
+#ifndef __EMSCRIPTEN__
+// Shared-memory layout: SharedTableHeader (padded to 64 bytes), then the entries
+const char SHARED_TABLE_MAGIC[4] = {'C', 'H', 'S', 'M'};
+
+struct SharedTableHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t entryCount;
+    uint8_t reserved[48];
+};
+static_assert(sizeof(SharedTableHeader) == 64, "shared table header must stay 64 bytes");
+
+static void* sharedMapping = nullptr;
+static size_t sharedMappingSize = 0;
+#endif
+
+// Switches back to a cleared process-local table of 'entries' entries
+static void useLocalTable(size_t entries) {
+    detachSharedHashTable();
+    localTable.assign(entries, TTEntry{0, 0});
+    table = localTable.data();
+    tableEntries = entries;
+    tableMask = entries - 1;
+}
+
+struct BestMoveEntry {
+    uint64_t key;
+    Move move;
+    uint8_t depth;
+    uint8_t reserved[5];
+};
+static_assert(sizeof(BestMoveEntry) == 16, "best-move record must stay 16 bytes");
+
+const size_t BEST_MOVE_STORE_CAPACITY = 1 << 16;
+static std::vector<BestMoveEntry> bestMoves; // Sorted by key
+
+// ----- Hash file format -----
+// HashFileHeader, then entryCount TTEntries, then bestMoveCount BestMoveEntries (little-endian).
+// Bump the version when a search change alters stored scores or moves.
+const char HASH_FILE_MAGIC[4] = {'C', 'H', 'T', 'T'};
+const uint32_t HASH_FILE_VERSION = 2;
+
+struct HashFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t entryCount;
+    uint64_t bestMoveCount;
+    uint64_t evalFingerprint; // evalFingerprint() of the engine that wrote the file
+};
+
+// FNV-1a over the evaluation parameters: stored scores are only valid for the
+// eval that produced them, so a retuned eval_params.h rejects older files
+static uint64_t evalFingerprint() {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    auto mix = [&hash](const int* values, size_t count) {
+        const uint8_t* bytes = (const uint8_t*)values;
+        for (size_t i = 0; i < count * sizeof(int); ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ULL;
+        }
+    };
+    mix(pieceValues, 13);
+    mix(pawnPST, 64);
+    mix(knightPST, 64);
+    mix(bishopPST, 64);
+    mix(rookPST, 64);
+    mix(queenPST, 64);
+    mix(kingPST, 64);
+    return hash;
+}
+
+static uint64_t packEntry(int score, Move move, int depth, int bound) {
+    return (uint64_t)(uint32_t)score |
+           ((uint64_t)move << 32) |
+           ((uint64_t)(uint8_t)depth << 48) |
+           ((uint64_t)(uint8_t)bound << 56);
+}
+
+bool ttProbe(uint64_t key, int& score, Move& move, int& depth, int& bound) {
+    const TTEntry& entry = table[key & tableMask];
+    uint64_t data = entry.data;
+    if ((entry.check ^ data) != key || data == 0) return false;
+
+    score = (int32_t)(uint32_t)data;
+    move = (Move)(data >> 32);
+    depth = (int8_t)(data >> 48);
+    bound = (uint8_t)(data >> 56);
+    return true;
+}
+
+void ttStore(uint64_t key, int score, Move move, int depth, int bound) {
+    TTEntry& entry = table[key & tableMask];
+
+    // Keep a deeper result for the same position; otherwise the newest entry wins
+    uint64_t old = entry.data;
+    if ((entry.check ^ old) == key && (int8_t)(old >> 48) > depth) return;
+
+    uint64_t data = packEntry(score, move, depth, bound);
+    entry.data = data;
+    entry.check = key ^ data;
+}
+
+bool bestMoveLookup(uint64_t key, Move& move, int& depth) {
+    auto it = std::lower_bound(bestMoves.begin(), bestMoves.end(), key,
+                               [](const BestMoveEntry& e, uint64_t k) { return e.key < k; });
+    if (it == bestMoves.end() || it->key != key) return false;
+    move = it->move;
+    depth = it->depth;
+    return true;
+}
+
+void bestMoveRecord(uint64_t key, Move move, int depth) {
+    if (depth < BEST_MOVE_STORE_MIN_DEPTH) return;
+
+    auto it = std::lower_bound(bestMoves.begin(), bestMoves.end(), key,
+                               [](const BestMoveEntry& e, uint64_t k) { return e.key < k; });
+    if (it != bestMoves.end() && it->key == key) {
+        if (depth >= it->depth) {
+            it->move = move;
+            it->depth = depth;
+        }
+        return;
+    }
+    if (bestMoves.size() >= BEST_MOVE_STORE_CAPACITY) return;
+
+    BestMoveEntry entry = {};
+    entry.key = key;
+    entry.move = move;
+    entry.depth = depth;
+    bestMoves.insert(it, entry);
+}
+
+extern "C" {
+
+    // Rounds down to a power-of-two entry count; clears the table
+    bool resizeHashTable(int megabytes) {
+        if (megabytes < 1) return false;
+        size_t entries = 1;
+        while (entries * 2 * sizeof(TTEntry) <= (size_t)megabytes * 1024 * 1024) entries *= 2;
+
+        useLocalTable(entries);
+        return true;
+    }
+
+    void clearHashTable() {
+        std::fill(table, table + tableEntries, TTEntry{0, 0});
+        bestMoves.clear();
+    }
+
+    bool saveHashTable(const char* path) {
+        FILE* out = fopen(path, "wb");
+        if (!out) return false;
+
+        HashFileHeader header;
+        memcpy(header.magic, HASH_FILE_MAGIC, 4);
+        header.version = HASH_FILE_VERSION;
+        header.entryCount = tableEntries;
+        header.bestMoveCount = bestMoves.size();
+        header.evalFingerprint = evalFingerprint();
+
+        bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+                  fwrite(table, sizeof(TTEntry), tableEntries, out) == tableEntries &&
+                  fwrite(bestMoves.data(), sizeof(BestMoveEntry), bestMoves.size(), out) == bestMoves.size();
+        return (fclose(out) == 0) && ok;
+    }
+
+    // Maps the file and copies it in; the current table is left alone if the file is unusable
+    bool loadHashTable(const char* path) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(HashFileHeader)) {
+            close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) return false;
+
+        const HashFileHeader* header = (const HashFileHeader*)mapping;
+        // Counts are bounded by the file size before multiplying, so a corrupt header cannot wrap the size check
+        uint64_t payloadSize = st.st_size - sizeof(HashFileHeader);
+        bool valid = memcmp(header->magic, HASH_FILE_MAGIC, 4) == 0 &&
+                     header->version == HASH_FILE_VERSION &&
+                     header->evalFingerprint == evalFingerprint() &&
+                     header->entryCount != 0 &&
+                     (header->entryCount & (header->entryCount - 1)) == 0 &&
+                     header->entryCount <= payloadSize / sizeof(TTEntry) &&
+                     header->bestMoveCount <= BEST_MOVE_STORE_CAPACITY &&
+                     header->bestMoveCount <= payloadSize / sizeof(BestMoveEntry) &&
+                     payloadSize == header->entryCount * sizeof(TTEntry) +
+                                    header->bestMoveCount * sizeof(BestMoveEntry);
+
+        if (valid) {
+            const TTEntry* entries = (const TTEntry*)(header + 1);
+            const BestMoveEntry* stored = (const BestMoveEntry*)(entries + header->entryCount);
+            // A shared table of the same size is filled in place for every attached process
+            if (header->entryCount != tableEntries) useLocalTable(header->entryCount);
+            std::copy(entries, entries + header->entryCount, table);
+            bestMoves.assign(stored, stored + header->bestMoveCount);
+            std::sort(bestMoves.begin(), bestMoves.end(),
+                      [](const BestMoveEntry& a, const BestMoveEntry& b) { return a.key < b.key; });
+        }
+
+        munmap(mapping, st.st_size);
+        return valid;
+    }
+
+#ifndef __EMSCRIPTEN__
+    bool attachSharedHashTable(const char* name, int megabytes, bool create) {
+        // O_EXCL: resizing a segment that other processes still map would SIGBUS them
+        int fd = shm_open(name, create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+        if (fd < 0) return false;
+
+        size_t mappingSize;
+        if (create) {
+            if (megabytes < 1) {
+                close(fd);
+                shm_unlink(name);
+                return false;
+            }
+            size_t entries = 1;
+            while (entries * 2 * sizeof(TTEntry) <= (size_t)megabytes * 1024 * 1024) entries *= 2;
+            mappingSize = sizeof(SharedTableHeader) + entries * sizeof(TTEntry);
+            if (ftruncate(fd, mappingSize) != 0) {
+                close(fd);
+                shm_unlink(name);
+                return false;
+            }
+        } else {
+            struct stat st;
+            if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SharedTableHeader)) {
+                close(fd);
+                return false;
+            }
+            mappingSize = st.st_size;
+        }
+
+        void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            if (create) shm_unlink(name);
+            return false;
+        }
+
+        SharedTableHeader* header = (SharedTableHeader*)mapping;
+        uint64_t maxEntries = (mappingSize - sizeof(SharedTableHeader)) / sizeof(TTEntry);
+        if (create) {
+            // A new segment starts zeroed (empty)
+            memcpy(header->magic, SHARED_TABLE_MAGIC, 4);
+            header->version = HASH_FILE_VERSION;
+            header->entryCount = maxEntries;
+        } else if (memcmp(header->magic, SHARED_TABLE_MAGIC, 4) != 0 ||
+                   header->version != HASH_FILE_VERSION ||
+                   header->entryCount == 0 ||
+                   (header->entryCount & (header->entryCount - 1)) != 0 ||
+                   header->entryCount > maxEntries) {
+            munmap(mapping, mappingSize);
+            return false;
+        }
+
+        detachSharedHashTable();
+        sharedMapping = mapping;
+        sharedMappingSize = mappingSize;
+        table = (TTEntry*)(header + 1);
+        tableEntries = header->entryCount;
+        tableMask = tableEntries - 1;
+        localTable.clear();
+        localTable.shrink_to_fit();
+        return true;
+    }
+#endif
+
+    void detachSharedHashTable() {
+#ifndef __EMSCRIPTEN__
+        if (!sharedMapping) return;
+        munmap(sharedMapping, sharedMappingSize);
+        sharedMapping = nullptr;
+        sharedMappingSize = 0;
+
+        localTable.assign(TT_DEFAULT_ENTRIES, TTEntry{0, 0});
+        table = localTable.data();
+        tableEntries = TT_DEFAULT_ENTRIES;
+        tableMask = TT_DEFAULT_ENTRIES - 1;
+#endif
+    }
+
+}
@@ -0,0 +1,52 @@
+#ifndef TT_H
+#define TT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "move.h"
+
+// Transposition table shared by all search threads.
+//
+// Each entry packs score, move, depth and bound into one 64-bit word and stores
+// it next to key ^ data. A torn write from another thread then fails the key
+// check instead of returning a mixed-up entry, so no locking is needed.
+
+const uint8_t TT_BOUND_EXACT = 1;
+const uint8_t TT_BOUND_LOWER = 2; // Score is at least the stored value
+const uint8_t TT_BOUND_UPPER = 3; // Score is at most the stored value
+
+struct TTEntry {
+    uint64_t check; // key ^ data
+    uint64_t data;  // bits 0-31 score, 32-47 move, 48-55 depth, 56-63 bound
+};
+
+// Default size fits in the browser build's initial 16 MB heap
+const size_t TT_DEFAULT_ENTRIES = 1 << 16; // 1 MB
+
+bool ttProbe(uint64_t key, int& score, Move& move, int& depth, int& bound);
+void ttStore(uint64_t key, int score, Move move, int depth, int bound);
+
+// Best moves for positions searched to high depth, kept sorted by key
+// and saved with the table
+const int BEST_MOVE_STORE_MIN_DEPTH = 4;
+bool bestMoveLookup(uint64_t key, Move& move, int& depth);
+void bestMoveRecord(uint64_t key, Move move, int depth);
+
+extern "C" {
+    bool resizeHashTable(int megabytes);
+    void clearHashTable();
+    // Versioned binary file with the table and the best-move store; both return false on failure
+    bool saveHashTable(const char* path);
+    bool loadHashTable(const char* path);
+
+#ifndef __EMSCRIPTEN__
+    // Moves the table into POSIX shared memory 'name' (e.g. "/chess-tt") so several
+    // engine processes search with one table. The creator makes a new segment of the
+    // given size (failing if 'name' exists); others attach as is.
+    bool attachSharedHashTable(const char* name, int megabytes, bool create);
+#endif
+    // Back to a process-local table (the shared segment itself is left for shm_unlink)
+    void detachSharedHashTable();
+}
+
+#endif // TT_H
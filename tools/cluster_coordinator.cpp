@@ -0,0 +1,138 @@
+// Local stand-in coordinator for the analysis cluster (see src/cluster.h).
+//
+// Usage: cluster_coordinator [-w workers] [-e external] [-d depth] [-mb hashMB]
+//                            [-s socket] [-t table] [moves...]
+//
+// Creates the shared transposition table, forks 'workers' local worker
+// processes, waits for 'external' more cluster_worker processes to connect,
+// then searches the position reached from the start by 'moves' (coordinate
+// notation, e.g. e2e4 e7e5 e7e8q) and prints the best move.
+
+#include "../src/cluster.h"
+#include "../src/engine.h"
+#include "../src/main.h"
+#include "../src/tt.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+const int ACCEPT_TIMEOUT_MS = 10000;
+
+static void squareName(int square, char* out) {
+    out[0] = 'a' + square % 8;
+    out[1] = '1' + square / 8;
+}
+
+static void moveName(Move move, char out[6]) {
+    squareName(moveFrom(move), out);
+    squareName(moveTo(move), out + 2);
+    out[4] = isPromotion(move) ? "nbrq"[moveFlags(move) & 3] : '\0';
+    out[5] = '\0';
+}
+
+// Plays one coordinate-notation move for the side to move
+static bool playCoordinateMove(const char* text) {
+    Move legalMoves[MAX_LEGAL_MOVES];
+    int moveCount = generateLegalMoves(currentTurn() == 1, legalMoves);
+    for (int i = 0; i < moveCount; ++i) {
+        char name[6];
+        moveName(legalMoves[i], name);
+        // A bare promotion (e7e8) means a queen
+        bool match = strcmp(name, text) == 0 ||
+                     (strlen(text) == 4 && strncmp(name, text, 4) == 0 && (name[4] == '\0' || name[4] == 'q'));
+        if (match) return playMove(legalMoves[i]);
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    int localWorkers = (int)std::thread::hardware_concurrency();
+    int externalWorkers = 0;
+    int depth = 4;
+    int hashMegabytes = 64;
+    const char* socketPath = "/tmp/chess-cluster.sock";
+    const char* tableName = "/chess-cluster-tt";
+
+    initBoard();
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-w") == 0 && hasValue) localWorkers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-e") == 0 && hasValue) externalWorkers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && hasValue) depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-mb") == 0 && hasValue) hashMegabytes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && hasValue) socketPath = argv[++i];
+        else if (strcmp(argv[i], "-t") == 0 && hasValue) tableName = argv[++i];
+        else if (!playCoordinateMove(argv[i])) {
+            fprintf(stderr, "Illegal or unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    int totalWorkers = localWorkers + externalWorkers;
+    if (totalWorkers < 1) {
+        fprintf(stderr, "Need at least one worker\n");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN); // Crashed workers show up as failed sends
+
+    shm_unlink(tableName); // Left over from an earlier coordinator; live mappings are unaffected
+    if (!attachSharedHashTable(tableName, hashMegabytes, true)) {
+        perror("shared table");
+        return 1;
+    }
+    int listenFd = clusterListen(socketPath, totalWorkers);
+    if (listenFd < 0) {
+        perror(socketPath);
+        shm_unlink(tableName);
+        return 1;
+    }
+
+    for (int i = 0; i < localWorkers; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(listenFd);
+            _exit(runClusterWorker(socketPath, tableName));
+        }
+        if (pid < 0) perror("fork");
+    }
+
+    std::vector<int> workerFds;
+    while ((int)workerFds.size() < totalWorkers) {
+        pollfd listening = {listenFd, POLLIN, 0};
+        if (poll(&listening, 1, ACCEPT_TIMEOUT_MS) <= 0) break;
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd >= 0) workerFds.push_back(fd);
+    }
+    printf("%zu/%d workers connected\n", workerFds.size(), totalWorkers);
+
+    bool white = currentTurn() == 1;
+    auto start = std::chrono::steady_clock::now();
+    Move best = clusterFindBestMove(workerFds, white, depth);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int exitCode = 0;
+    if (best == MOVE_NONE) {
+        fprintf(stderr, "No result (no legal moves or no workers left)\n");
+        exitCode = 1;
+    } else {
+        char name[6];
+        moveName(best, name);
+        printf("bestmove %s depth %d time %.2fs workers %zu\n", name, depth, seconds, workerFds.size());
+    }
+
+    clusterShutdown(workerFds);
+    while (wait(nullptr) > 0) {}
+    close(listenFd);
+    unlink(socketPath);
+    detachSharedHashTable();
+    shm_unlink(tableName);
+    return exitCode;
+}
@@ -0,0 +1,17 @@
+// Engine worker process for the analysis cluster (see src/cluster.h).
+//
+// Usage: cluster_worker <socket> <shared-table-name>
+//
+// cluster_coordinator starts its own workers; run this to add more processes
+// to a running coordinator.
+
+#include "../src/cluster.h"
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <socket> <shared-table-name>\n", argv[0]);
+        return 1;
+    }
+    return runClusterWorker(argv[1], argv[2]);
+}
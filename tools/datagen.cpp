@@ -0,0 +1,119 @@
+// Self-play generator for the Texel tuner dataset (see texel_dataset.h).
+//
+// Usage: datagen <output> [-g games] [-d depth] [-r randomPlies] [-s seed]
+//
+// Each game opens with a few random legal moves for variety, then both sides
+// play findBestMove at the given depth. Quiet positions (side to move not in
+// check, previous move not a capture) are labelled with the final result.
+
+#include "../src/engine.h"
+#include "../src/main.h"
+#include "texel_dataset.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+const int MAX_GAME_PLIES = 300; // Longer games are adjudicated as draws
+
+// Plays one game and appends its quiet positions to 'records'
+static void playGame(int depth, int randomPlies, std::mt19937& rng, std::vector<TexelRecord>& records) {
+    initBoard();
+    size_t firstRecord = records.size();
+    uint8_t result = TEXEL_RESULT_DRAW;
+    bool lastMoveWasCapture = false;
+
+    for (int ply = 0; ply < MAX_GAME_PLIES; ++ply) {
+        uint8_t* state = getGameState();
+        uint8_t flags = state[0];
+        bool white = state[1] == 1;
+        int moveCount = state[3];
+
+        if (flags & GAME_STATUS_CHECKMATE) {
+            result = white ? TEXEL_RESULT_BLACK_WIN : TEXEL_RESULT_WHITE_WIN;
+            break;
+        }
+        if (flags & (GAME_STATUS_STALEMATE | GAME_STATUS_INSUFFICIENT_MATERIAL | GAME_STATUS_REPETITION)) {
+            break;
+        }
+
+        if (ply >= randomPlies && !(flags & GAME_STATUS_CHECK) && !lastMoveWasCapture) {
+            TexelRecord record;
+            packBoard(board, record);
+            record.whiteToMove = white;
+            records.push_back(record);
+        }
+
+        Move move;
+        if (ply < randomPlies) {
+            int pick = std::uniform_int_distribution<int>(0, moveCount - 1)(rng);
+            const uint8_t* moves = state + GAME_STATE_HEADER_SIZE;
+            move = moves[pick * 2] | (moves[pick * 2 + 1] << 8);
+        } else {
+            move = findBestMove(white, depth);
+        }
+
+        // Promotions are part of the move, so nothing is left pending
+        if (!playMove(move)) break;
+        lastMoveWasCapture = isCapture(move);
+    }
+
+    for (size_t i = firstRecord; i < records.size(); ++i) {
+        records[i].result = result;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <output> [-g games] [-d depth] [-r randomPlies] [-s seed]\n", argv[0]);
+        return 1;
+    }
+
+    const char* outputPath = argv[1];
+    int games = 100;
+    int depth = 2;
+    int randomPlies = 8;
+    unsigned seed = 1;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-g") == 0) games = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-d") == 0) depth = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-r") == 0) randomPlies = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-s") == 0) seed = (unsigned)strtoul(argv[i + 1], nullptr, 10);
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<TexelRecord> records;
+    for (int game = 0; game < games; ++game) {
+        playGame(depth, randomPlies, rng, records);
+        fprintf(stderr, "\rGame %d/%d, %zu positions", game + 1, games, records.size());
+    }
+    fprintf(stderr, "\n");
+
+    FILE* out = fopen(outputPath, "wb");
+    if (!out) {
+        perror(outputPath);
+        return 1;
+    }
+
+    TexelDatasetHeader header;
+    memcpy(header.magic, TEXEL_DATASET_MAGIC, 4);
+    header.version = TEXEL_DATASET_VERSION;
+    header.count = records.size();
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(records.data(), sizeof(TexelRecord), records.size(), out) == records.size();
+    ok = (fclose(out) == 0) && ok;
+    if (!ok) {
+        fprintf(stderr, "Failed to write %s\n", outputPath);
+        return 1;
+    }
+
+    printf("Wrote %zu positions to %s\n", records.size(), outputPath);
+    return 0;
+}
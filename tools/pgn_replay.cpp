@@ -0,0 +1,92 @@
+// Bulk PGN validator and replay benchmark (see src/pgn.h).
+//
+// Usage: pgn_replay [-san] [-v] <file.pgn>...
+//
+// Streams every game of each file through SAN parsing and the legal move
+// generator and reports games, moves and moves per second. A game fails when
+// one of its moves is not legal (or ambiguous) in the engine's eyes.
+// -san also regenerates every move's SAN and counts those that differ from
+// the text (annotations like ! and ? aside); -v names each failing game.
+
+#include "../src/main.h"
+#include "../src/pgn.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+struct ReplayStats {
+    long games = 0;
+    long failedGames = 0;
+    long moves = 0;
+    long sanMismatches = 0;
+};
+
+static void checkSan(Move move, const char* san, size_t sanLength, bool, void* context) {
+    ReplayStats* stats = (ReplayStats*)context;
+    while (sanLength > 0 && (san[sanLength - 1] == '!' || san[sanLength - 1] == '?')) sanLength--;
+
+    char written[SAN_MAX_LENGTH];
+    size_t length = formatSAN(move, written);
+    if (length != sanLength || memcmp(written, san, length) != 0) stats->sanMismatches++;
+}
+
+static std::string tagValue(const PgnGame& game, const char* name) {
+    const PgnTag* tag = pgnFindTag(game, name);
+    return tag ? std::string(tag->value, tag->valueLength) : "?";
+}
+
+int main(int argc, char** argv) {
+    bool verifySan = false;
+    bool verbose = false;
+    int files = 0;
+    ReplayStats stats;
+    double seconds = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-san") == 0) {
+            verifySan = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+            continue;
+        }
+
+        PgnReader reader;
+        if (!pgnOpenFile(reader, argv[i])) {
+            perror(argv[i]);
+            return 1;
+        }
+        files++;
+
+        auto start = std::chrono::steady_clock::now();
+        PgnGame game;
+        while (pgnNextGame(reader, game)) {
+            stats.games++;
+            bool white;
+            int played = pgnReplayGame(game, white, verifySan ? checkSan : nullptr, &stats);
+            if (played < 0) {
+                stats.failedGames++;
+                if (verbose) {
+                    printf("%s: game %ld (%s - %s) has an illegal move\n", argv[i], stats.games,
+                           tagValue(game, "White").c_str(), tagValue(game, "Black").c_str());
+                }
+                continue;
+            }
+            stats.moves += played;
+        }
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        pgnClose(reader);
+    }
+
+    if (files == 0) {
+        fprintf(stderr, "Usage: %s [-san] [-v] <file.pgn>...\n", argv[0]);
+        return 1;
+    }
+
+    printf("%ld games, %ld moves, %ld failed games in %.2fs (%.0f moves/s)\n",
+           stats.games, stats.moves, stats.failedGames, seconds, seconds > 0 ? stats.moves / seconds : 0.0);
+    if (verifySan) printf("%ld SAN mismatches\n", stats.sanMismatches);
+    return stats.failedGames == 0 ? 0 : 2;
+}
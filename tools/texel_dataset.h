@@ -0,0 +1,44 @@
+#ifndef TEXEL_DATASET_H
+#define TEXEL_DATASET_H
+
+#include <stdint.h>
+
+// Binary dataset of labelled positions shared by datagen and texel_tuner.
+// File = TexelDatasetHeader followed by 'count' TexelRecords, little-endian.
+
+const char TEXEL_DATASET_MAGIC[4] = {'T', 'X', 'L', 'D'};
+const uint32_t TEXEL_DATASET_VERSION = 1;
+
+// Game results from White's point of view
+const uint8_t TEXEL_RESULT_BLACK_WIN = 0;
+const uint8_t TEXEL_RESULT_DRAW = 1;
+const uint8_t TEXEL_RESULT_WHITE_WIN = 2;
+
+struct TexelDatasetHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+};
+
+// One position: board piece codes packed two squares per byte (low nibble first)
+struct TexelRecord {
+    uint8_t squares[32];
+    uint8_t whiteToMove;
+    uint8_t result; // TEXEL_RESULT_*
+};
+
+static_assert(sizeof(TexelDatasetHeader) == 16, "dataset header must stay 16 bytes");
+static_assert(sizeof(TexelRecord) == 34, "dataset record must stay 34 bytes");
+
+inline void packBoard(const uint8_t board[64], TexelRecord& record) {
+    for (int i = 0; i < 32; ++i) {
+        record.squares[i] = board[i * 2] | (board[i * 2 + 1] << 4);
+    }
+}
+
+inline uint8_t recordPiece(const TexelRecord& record, int square) {
+    uint8_t pair = record.squares[square / 2];
+    return (square % 2 == 0) ? (pair & 0x0F) : (pair >> 4);
+}
+
+#endif // TEXEL_DATASET_H
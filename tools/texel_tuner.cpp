@@ -0,0 +1,297 @@
+// Texel tuner for the evaluation parameters in src/eval_params.h.
+//
+// Usage: texel_tuner <dataset> [-o output] [-t threads] [-e epochs] [-lr rate]
+//
+// Reads a dataset written by datagen through a memory-mapped file, fits the
+// sigmoid scale K to the current parameters, then minimises the Texel loss
+//     mean((result - sigmoid(K * eval / 400))^2)
+// over piece values and PSTs with full-batch Adam. The gradient is summed
+// over dataset slices on worker threads. The result is written as a new
+// eval_params.h, starting from the values the tuner was compiled with.
+
+#include "../src/eval_params.h"
+#include "texel_dataset.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Parameter vector: material for pawn..queen, then one 64-entry PST per piece type.
+// The king's material value is constant on both sides and cancels out, so it is not tuned.
+const int MATERIAL_PARAMS = 5;
+const int PIECE_TYPES = 6;
+const int PARAM_COUNT = MATERIAL_PARAMS + PIECE_TYPES * 64;
+
+static const int* const pstTables[PIECE_TYPES] = {
+    pawnPST, knightPST, bishopPST, rookPST, queenPST, kingPST
+};
+static const char* const pstNames[PIECE_TYPES] = {
+    "pawnPST", "knightPST", "bishopPST", "rookPST", "queenPST", "kingPST"
+};
+static const char* const pieceNames[13] = {
+    "Empty", "White Pawn", "Black Pawn", "White Knight", "Black Knight", "White Bishop",
+    "Black Bishop", "White Rook", "Black Rook", "White Queen", "Black Queen", "White King", "Black King"
+};
+
+struct Dataset {
+    const TexelRecord* records = nullptr;
+    size_t count = 0;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+};
+
+static bool openDataset(const char* path, Dataset& dataset) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TexelDatasetHeader)) {
+        fprintf(stderr, "%s: not a dataset file\n", path);
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+
+    const TexelDatasetHeader* header = (const TexelDatasetHeader*)mapping;
+    size_t expectedSize = sizeof(TexelDatasetHeader) + header->count * sizeof(TexelRecord);
+    if (memcmp(header->magic, TEXEL_DATASET_MAGIC, 4) != 0 ||
+        header->version != TEXEL_DATASET_VERSION ||
+        (size_t)st.st_size < expectedSize) {
+        fprintf(stderr, "%s: bad header or truncated dataset\n", path);
+        munmap(mapping, st.st_size);
+        return false;
+    }
+
+    // Records are read sequentially every epoch
+    madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+
+    dataset.records = (const TexelRecord*)((const char*)mapping + sizeof(TexelDatasetHeader));
+    dataset.count = header->count;
+    dataset.mapping = mapping;
+    dataset.mappingSize = st.st_size;
+    return true;
+}
+
+// Same square mapping as pstScoreForPiece in engine.cpp
+inline int mirrorIndex(int idx) {
+    return (7 - idx / 8) * 8 + idx % 8;
+}
+
+// Calls visit(paramIndex, sign) for every parameter the position's evaluation uses
+template <typename Visit>
+inline void forEachFeature(const TexelRecord& record, Visit visit) {
+    for (int sq = 0; sq < 64; ++sq) {
+        int piece = recordPiece(record, sq);
+        if (piece == 0 || piece > 12) continue;
+
+        int type = (piece - 1) / 2;
+        bool isWhite = (piece % 2 == 1);
+        double sign = isWhite ? 1.0 : -1.0;
+        int pstIndex = isWhite ? mirrorIndex(sq) : sq;
+
+        if (type < MATERIAL_PARAMS) visit(type, sign);
+        visit(MATERIAL_PARAMS + type * 64 + pstIndex, sign);
+    }
+}
+
+inline double evaluate(const TexelRecord& record, const std::vector<double>& params) {
+    double score = 0;
+    forEachFeature(record, [&](int index, double sign) { score += sign * params[index]; });
+    return score;
+}
+
+inline double sigmoid(double k, double score) {
+    return 1.0 / (1.0 + std::pow(10.0, -k * score / 400.0));
+}
+
+inline double resultValue(const TexelRecord& record) {
+    return record.result * 0.5; // TEXEL_RESULT_* maps to 0, 0.5, 1
+}
+
+// Loss over the whole dataset; also sums the gradient into 'gradient' when non-null
+static double computeLoss(const Dataset& dataset, const std::vector<double>& params, double k,
+                          int threadCount, std::vector<double>* gradient) {
+    std::vector<double> losses(threadCount, 0.0);
+    std::vector<std::vector<double>> gradients(gradient ? threadCount : 0,
+                                               std::vector<double>(PARAM_COUNT, 0.0));
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            size_t begin = dataset.count * t / threadCount;
+            size_t end = dataset.count * (t + 1) / threadCount;
+            double loss = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const TexelRecord& record = dataset.records[i];
+                double predicted = sigmoid(k, evaluate(record, params));
+                double error = resultValue(record) - predicted;
+                loss += error * error;
+
+                if (gradient) {
+                    // d(error^2)/d(score), the per-feature factor is just the sign
+                    double slope = -2.0 * error * predicted * (1.0 - predicted) * k * std::log(10.0) / 400.0;
+                    std::vector<double>& local = gradients[t];
+                    forEachFeature(record, [&](int index, double sign) { local[index] += slope * sign; });
+                }
+            }
+            losses[t] = loss;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    double total = 0;
+    for (double loss : losses) total += loss;
+
+    if (gradient) {
+        gradient->assign(PARAM_COUNT, 0.0);
+        for (const std::vector<double>& local : gradients) {
+            for (int i = 0; i < PARAM_COUNT; ++i) (*gradient)[i] += local[i] / dataset.count;
+        }
+    }
+    return total / dataset.count;
+}
+
+// Scale K that best maps the starting evaluation onto the results
+static double fitK(const Dataset& dataset, const std::vector<double>& params, int threadCount) {
+    double bestK = 1.0;
+    double bestLoss = computeLoss(dataset, params, bestK, threadCount, nullptr);
+    for (double step = 0.1; step >= 0.001; step /= 10) {
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (double candidate : {bestK - step, bestK + step}) {
+                if (candidate <= 0) continue;
+                double loss = computeLoss(dataset, params, candidate, threadCount, nullptr);
+                if (loss < bestLoss) {
+                    bestLoss = loss;
+                    bestK = candidate;
+                    improved = true;
+                }
+            }
+        }
+    }
+    return bestK;
+}
+
+static void writeTable(FILE* out, const char* name, const std::vector<double>& params, int offset) {
+    fprintf(out, "const int %s[64] = {\n", name);
+    for (int rank = 0; rank < 8; ++rank) {
+        fprintf(out, " ");
+        for (int file = 0; file < 8; ++file) {
+            int i = rank * 8 + file;
+            fprintf(out, "%4ld%s", std::lround(params[offset + i]), i == 63 ? "" : ",");
+        }
+        fprintf(out, "\n");
+    }
+    fprintf(out, "};\n\n");
+}
+
+static bool writeHeader(const char* path, const std::vector<double>& params) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return false;
+    }
+
+    fprintf(out, "// Evaluation parameters included by engine.cpp.\n");
+    fprintf(out, "// Generated by tools/texel_tuner.cpp (make tune).\n\n");
+    fprintf(out, "#ifndef EVAL_PARAMS_H\n#define EVAL_PARAMS_H\n\n");
+
+    fprintf(out, "// Simple piece values\nconst int pieceValues[13] = {\n");
+    for (int piece = 0; piece < 13; ++piece) {
+        int type = (piece - 1) / 2;
+        long value = (piece == 0) ? 0
+                   : (type < MATERIAL_PARAMS) ? std::lround(params[type])
+                   : pieceValues[piece];
+        fprintf(out, "    %ld%s // %s\n", value, piece == 12 ? " " : ",", pieceNames[piece]);
+    }
+    fprintf(out, "};\n\n// PST arrays\n\n");
+
+    for (int type = 0; type < PIECE_TYPES; ++type) {
+        writeTable(out, pstNames[type], params, MATERIAL_PARAMS + type * 64);
+    }
+
+    fprintf(out, "#endif // EVAL_PARAMS_H\n");
+    return fclose(out) == 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <dataset> [-o output] [-t threads] [-e epochs] [-lr rate]\n", argv[0]);
+        return 1;
+    }
+
+    const char* datasetPath = argv[1];
+    const char* outputPath = "src/eval_params.h";
+    int threadCount = (int)std::thread::hardware_concurrency();
+    int epochs = 1000;
+    double learningRate = 1.0;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-o") == 0) outputPath = argv[i + 1];
+        else if (strcmp(argv[i], "-t") == 0) threadCount = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-e") == 0) epochs = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-lr") == 0) learningRate = atof(argv[i + 1]);
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (threadCount < 1) threadCount = 1;
+
+    Dataset dataset;
+    if (!openDataset(datasetPath, dataset)) return 1;
+    if (dataset.count == 0) {
+        fprintf(stderr, "%s: dataset is empty\n", datasetPath);
+        return 1;
+    }
+
+    std::vector<double> params(PARAM_COUNT);
+    for (int type = 0; type < MATERIAL_PARAMS; ++type) params[type] = pieceValues[type * 2 + 1];
+    for (int type = 0; type < PIECE_TYPES; ++type) {
+        for (int i = 0; i < 64; ++i) params[MATERIAL_PARAMS + type * 64 + i] = pstTables[type][i];
+    }
+
+    double k = fitK(dataset, params, threadCount);
+    printf("%zu positions, %d threads, K = %.3f, initial loss %.6f\n",
+           dataset.count, threadCount, k, computeLoss(dataset, params, k, threadCount, nullptr));
+
+    // Adam
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    std::vector<double> gradient, m(PARAM_COUNT, 0.0), v(PARAM_COUNT, 0.0);
+    for (int epoch = 1; epoch <= epochs; ++epoch) {
+        double loss = computeLoss(dataset, params, k, threadCount, &gradient);
+        for (int i = 0; i < PARAM_COUNT; ++i) {
+            m[i] = beta1 * m[i] + (1 - beta1) * gradient[i];
+            v[i] = beta2 * v[i] + (1 - beta2) * gradient[i] * gradient[i];
+            double mHat = m[i] / (1 - std::pow(beta1, epoch));
+            double vHat = v[i] / (1 - std::pow(beta2, epoch));
+            params[i] -= learningRate * mHat / (std::sqrt(vHat) + epsilon);
+        }
+        if (epoch % 50 == 0 || epoch == epochs) printf("Epoch %d: loss %.6f\n", epoch, loss);
+    }
+
+    munmap(dataset.mapping, dataset.mappingSize);
+
+    if (!writeHeader(outputPath, params)) {
+        fprintf(stderr, "Failed to write %s\n", outputPath);
+        return 1;
+    }
+    printf("Wrote %s\n", outputPath);
+    return 0;
+}